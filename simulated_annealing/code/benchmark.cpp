@@ -0,0 +1,254 @@
+/*
+benchmark.cpp
+Микробенчмарки горячих путей ИО: criteria, fullCriteria, clone, copyFrom, SwapTwoJobs::apply, MoveJob::apply,
+CoolingLaw::nextTemperature и полный цикл отжига (виртуальный SimulatedAnnealing, шаблонный
+StaticSimulatedAnnealing и, для малых N x M, LockstepAnnealing — 16 цепочек в SIMD-линиях). Для каждой операции — нс на операцию и число выделений памяти на операцию,
+по сетке размеров N x M и обеим раскладкам. Вывод машиночитаемый (CSV или JSON) — для сравнения между коммитами.
+Компиляция: g++ -std=c++17 benchmark.cpp -O2 -o benchmark
+Запуск: ./benchmark [--iters=2000000] [--sizes=1000x10,100000x100,1000000x1000] [--format=csv|json] [--filter=подстрока]
+*/
+
+#include <bits/stdc++.h>
+#include "headers/abstruct.h"
+#include "headers/simd_kernels.h"
+#include "headers/k1_index.h"
+#include "headers/job_durations.h"
+#include "headers/solution.h"
+#include "headers/flat_solution.h"
+#include "headers/solution_pool.h"
+#include "headers/operator_bandit.h"
+#include "headers/mutations.h"
+#include "headers/cooling_laws.h"
+#include "headers/telemetry.h"
+#include "headers/head_class.h"
+#include "headers/static_engine.h"
+#include "headers/rng_streams.h"
+#include "headers/lockstep_engine.h"
+#include "headers/data_io.h"
+#include "headers/cli_options.h"
+
+using namespace std;
+
+// ------------------------------ Счётчик выделений памяти ------------------------------
+// Глобальные operator new/delete подменены: каждое выделение увеличивает счётчик.
+// Все формы new и delete идут через одну пару функций: -Wmismatched-new-delete не видит free
+// на указателе из operator new.
+static atomic<long long> allocCount{0};
+
+static void *countedAlloc(size_t n, size_t align) {
+    allocCount.fetch_add(1, memory_order_relaxed);
+    n = max<size_t>(n, 1);
+    void *p = align ? aligned_alloc(align, (n + align - 1) / align * align) : malloc(n);
+    if (!p) throw bad_alloc();
+    return p;
+}
+static void countedFree(void *p) noexcept { free(p); }
+
+void *operator new(size_t n) { return countedAlloc(n, 0); }
+void *operator new[](size_t n) { return countedAlloc(n, 0); }
+void operator delete(void *p) noexcept { countedFree(p); }
+void operator delete[](void *p) noexcept { countedFree(p); }
+void operator delete(void *p, size_t) noexcept { countedFree(p); }
+void operator delete[](void *p, size_t) noexcept { countedFree(p); }
+
+void *operator new(size_t n, align_val_t a) { return countedAlloc(n, size_t(a)); }
+void *operator new[](size_t n, align_val_t a) { return countedAlloc(n, size_t(a)); }
+void operator delete(void *p, align_val_t) noexcept { countedFree(p); }
+void operator delete[](void *p, align_val_t) noexcept { countedFree(p); }
+void operator delete(void *p, size_t, align_val_t) noexcept { countedFree(p); }
+void operator delete[](void *p, size_t, align_val_t) noexcept { countedFree(p); }
+
+// ------------------------------ Замер ------------------------------
+struct BenchResult {
+    string name;
+    int N, M;
+    string layout;
+    long long ops;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+static volatile double sink; // не даёт компилятору выбросить замеряемый код
+
+// run(ops) выполняет ops операций; замеряются время и выделения памяти внутри
+template <class F>
+BenchResult measure(const string &name, int N, int M, const string &layout, long long ops, F &&run) {
+    long long allocs0 = allocCount.load();
+    auto start = chrono::steady_clock::now();
+    run(ops);
+    auto finish = chrono::steady_clock::now();
+    long long allocs = allocCount.load() - allocs0;
+    return {name, N, M, layout, ops,
+            chrono::duration<double, nano>(finish - start).count() / ops, double(allocs) / ops};
+}
+
+// "1000x10,100000x100" -> {{1000,10},{100000,100}}
+vector<pair<int, int>> parseSizes(const string &s) {
+    vector<pair<int, int>> sizes;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t x = item.find('x');
+        if (x == string::npos) throw runtime_error("размер должен быть в виде NxM: " + item);
+        sizes.push_back({stoi(item.substr(0, x)), stoi(item.substr(x + 1))});
+    }
+    return sizes;
+}
+
+void printCSV(const vector<BenchResult> &rs) {
+    cout << "bench,N,M,layout,ops,ns_per_op,allocs_per_op\n";
+    for (const auto &r : rs)
+        cout << r.name << "," << r.N << "," << r.M << "," << r.layout << "," << r.ops << ","
+             << fixed << setprecision(2) << r.nsPerOp << "," << setprecision(4) << r.allocsPerOp << "\n";
+}
+
+void printJSON(const vector<BenchResult> &rs) {
+    cout << "[\n";
+    for (size_t i = 0; i < rs.size(); ++i) {
+        const auto &r = rs[i];
+        cout << "  {\"bench\": \"" << r.name << "\", \"N\": " << r.N << ", \"M\": " << r.M
+             << ", \"layout\": \"" << r.layout << "\", \"ops\": " << r.ops << fixed << setprecision(2)
+             << ", \"ns_per_op\": " << r.nsPerOp << setprecision(4)
+             << ", \"allocs_per_op\": " << r.allocsPerOp << "}" << (i + 1 < rs.size() ? "," : "") << "\n";
+    }
+    cout << "]\n";
+}
+
+int main(int argc, char** argv) {
+    Options opts = extractOptions(argc, argv);
+    long long iterations = opts.getInt("iters", 2000000);
+    vector<pair<int, int>> sizes = parseSizes(opts.get("sizes", "1000x10,100000x100,1000000x1000"));
+    string format = opts.get("format", "csv");
+    string filter = opts.get("filter", "");
+
+    const double T0 = 100.0;
+    const int noLimit = numeric_limits<int>::max(); // отжиг останавливается только по числу итераций
+    const uint32_t seed = 12345;
+
+    vector<BenchResult> results;
+    auto add = [&](const string &name, int N, int M, const string &layout, long long ops, auto &&run) {
+        if (!filter.empty() && name.find(filter) == string::npos) return;
+        results.push_back(measure(name, N, M, layout, max(ops, 1LL), run));
+    };
+
+    // законы охлаждения от размера не зависят — замеряются один раз
+    vector<pair<string, shared_ptr<CoolingLaw>>> laws = {
+        {"cooling_boltzmann", make_shared<BoltzmannCooling>(T0)},
+        {"cooling_cauchy", make_shared<CauchyCooling>(T0)},
+        {"cooling_mixed", make_shared<MixedCooling>(T0)},
+    };
+    for (auto &[name, law] : laws) {
+        add(name, 0, 0, "-", iterations, [&](long long ops) {
+            double T = T0;
+            for (long long k = 1; k <= ops; ++k) T = law->nextTemperature(T, int(k));
+            sink = T;
+        });
+        // те же температуры из заполненной таблицы — так их читают движки на повторных заходах
+        TemperatureTable table(T0);
+        for (int k = 1; k < TemperatureTable::MAX_SIZE; ++k) table.next(*law, table.T.back(), k);
+        add(name + "_table", 0, 0, "-", iterations, [&](long long ops) {
+            double T = T0;
+            for (long long k = 1; k <= ops; ++k) T = table.next(*law, T, int(k % TemperatureTable::MAX_SIZE));
+            sink = T;
+        });
+    }
+
+    // критерий Metropolis: прежняя форма с exp и пороговая с fastLog (см. metropolisAccept; delta <= 50 < 44.37 * T — всегда ветка с логарифмом)
+    {
+        mt19937 rng(seed);
+        uniform_real_distribution<double> unit(0.0, 1.0);
+        vector<double> deltas(1024);
+        for (double &d : deltas) d = 1 + int(rng() % 50);
+        add("metropolis_exp", 0, 0, "-", iterations, [&](long long ops) {
+            long long acc = 0;
+            for (long long k = 0; k < ops; ++k) acc += std::exp(-deltas[k & 1023] / 10.0) >= unit(rng);
+            sink = acc;
+        });
+        add("metropolis_fastlog", 0, 0, "-", iterations, [&](long long ops) {
+            long long acc = 0;
+            for (long long k = 0; k < ops; ++k) acc += metropolisAccept(deltas[k & 1023], 10.0, rng, unit);
+            sink = acc;
+        });
+    }
+
+    for (auto [N, M] : sizes) {
+        mt19937 gen(seed);
+        vector<int> w = generateDurations(N, 1, 100, gen);
+        // полный пересчёт и clone проходят всё решение — повторов меньше, чтобы прогон шёл секунды
+        long long fullOps = max(1LL, iterations / max(1, N / 100));
+
+        auto suite = [&](const Solution &initial, const string &layout) {
+            add("criteria", N, M, layout, iterations, [&](long long ops) {
+                double acc = 0;
+                for (long long k = 0; k < ops; ++k) acc += initial.criteria();
+                sink = acc;
+            });
+            withSchedule(initial, [&](const auto &sch) {
+                add("full_criteria", N, M, layout, fullOps, [&](long long ops) {
+                    double acc = 0;
+                    for (long long k = 0; k < ops; ++k) acc += sch.fullCriteria();
+                    sink = acc;
+                });
+            });
+            add("clone", N, M, layout, fullOps, [&](long long ops) {
+                for (long long k = 0; k < ops; ++k) sink = initial.clone()->criteria();
+            });
+            // копия в уже выделенное решение — так копирует SolutionPool
+            add("copy_from", N, M, layout, fullOps, [&](long long ops) {
+                auto s = initial.clone();
+                for (long long k = 0; k < ops; ++k) s->copyFrom(initial);
+                sink = s->criteria();
+            });
+
+            // мутации применяются к рабочей копии подряд, без отката — как цепочка принятых ходов
+            auto mutationBench = [&](const string &name, const Mutation &mut) {
+                auto s = initial.clone();
+                mt19937 rng(seed);
+                add(name, N, M, layout, iterations, [&](long long ops) {
+                    for (long long k = 0; k < ops; ++k) mut.apply(*s, rng);
+                    sink = s->criteria();
+                });
+            };
+            mutationBench("swap_apply", SwapTwoJobs());
+            mutationBench("move_apply", MoveJob());
+
+            // полный цикл отжига: нс на итерацию
+            vector<shared_ptr<Mutation>> muts = {make_shared<SwapTwoJobs>(), make_shared<MoveJob>()};
+            add("anneal_virtual", N, M, layout, iterations, [&](long long ops) {
+                SimulatedAnnealing sa(T0, int(ops), noLimit, make_unique<CauchyCooling>(T0),
+                                      make_shared<CompositeMutation>(muts), seed);
+                sink = sa.run(initial)->criteria();
+            });
+            // прежний цикл с копией решения на итерацию (inPlace = false), копии берутся из SolutionPool
+            add("anneal_virtual_copies", N, M, layout, fullOps, [&](long long ops) {
+                SimulatedAnnealing sa(T0, int(ops), noLimit, make_unique<CauchyCooling>(T0),
+                                      make_shared<CompositeMutation>(muts), seed);
+                sa.inPlace = false;
+                sink = sa.run(initial)->criteria();
+            });
+            add("anneal_static", N, M, layout, iterations, [&](long long ops) {
+                sink = runStaticAnnealing(initial, "Cauchy", T0, int(ops), noLimit, seed)->criteria();
+            });
+            // 16 цепочек в SIMD-линиях (только малые экземпляры): нс на ход одной цепочки
+            if (LockstepAnnealing::fits(N, M)) {
+                auto lockstep = [&](const string &name, simd::LockstepStep step) {
+                    add(name, N, M, layout, iterations, [&](long long ops) {
+                        LockstepAnnealing la(T0, int(max(1LL, ops / LockstepAnnealing::LANES)), noLimit, seed);
+                        la.step = step;
+                        sink = la.run(initial, CauchyCooling(T0)).size();
+                    });
+                };
+                lockstep("anneal_lockstep", simd::lockstepStep());
+                lockstep("anneal_lockstep_scalar", simd::lockstepStepScalar);
+            }
+        };
+
+        ScheduleSolution lists(N, M, JobDurations(w));
+        suite(lists, "lists");
+        suite(FlatScheduleSolution(lists), "flat");
+    }
+
+    if (format == "json") printJSON(results);
+    else printCSV(results);
+    return 0;
+}
@@ -6,15 +6,50 @@ struct Solution {
     virtual double criteria() const = 0;
     // глубокая копия решения
     virtual unique_ptr<Solution> clone() const = 0;
+    // скопировать other (той же раскладки) в это решение, переиспользуя уже выделенную память
+    virtual void copyFrom(const Solution &other) = 0;
     // текстовое представление (для печати)
     virtual string toString() const = 0;
 };
 
+struct Mutation;
+
+// Компактная запись применённой мутации — всё, что нужно, чтобы её откатить.
+// by == nullptr означает, что решение не изменилось.
+struct MoveRecord {
+    const Mutation *by = nullptr;
+    int p1 = 0, i1 = 0, p2 = 0, i2 = 0;
+    bool neutral = false; // ход заведомо не меняет K1 (выставляет Mutation::applyFiltered)
+};
+
 struct Mutation {
     virtual ~Mutation() = default;
     // применить мутацию к решению (изменяет решение in-place)
     // Бросает bad_cast если тип решения не тот, который ожидает мутация.
-    virtual void apply(Solution &s, std::mt19937 &rng) const = 0;
+    virtual MoveRecord apply(Solution &s, std::mt19937 &rng) const = 0;
+    // как apply (те же числа из rng), но ход, который за O(1) опознан как нейтральный — не способный
+    // изменить K1, — не применяется: у записи выставлен neutral, применить его можно через redo
+    virtual MoveRecord applyFiltered(Solution &s, std::mt19937 &rng) const = 0;
+    // откатить мутацию rec; решение должно быть ровно в том состоянии, в котором его оставил apply
+    virtual void undo(Solution &s, const MoveRecord &rec) const = 0;
+    // применить ту же мутацию rec ещё раз к состоянию, в котором её выбрал apply (после undo)
+    virtual void redo(Solution &s, const MoveRecord &rec) const = 0;
+    // имя для отчёта по операторам
+    virtual std::string name() const = 0;
+    // движок принял ход rec, и тот уменьшил K1 на gain > 0 (адаптивная смесь засчитывает выигрыш оператору)
+    virtual void accepted(const MoveRecord &, double) const {}
+    // Мутация для нового движка (self — этот же объект). Мутации без состояния делят один объект между
+    // движками и потоками; у адаптивной смеси состояние своё, и каждый движок получает её копию
+    virtual std::shared_ptr<Mutation> forEngine(const std::shared_ptr<Mutation> &self) const { return self; }
+};
+
+// Состояние отжига между порциями итераций — для движков, которые умеют идти шагами
+struct AnnealState {
+    double T = 0;          // текущая температура
+    int iter = 0;          // итераций с начала отжига
+    int noImprove = 0;     // итераций подряд без принятия хода
+    double reference = 0;  // эталон K1 для Metropolis-теста (обновляется только при улучшении;
+                           // с currentEnergy движка — K1 текущего решения)
 };
 
 struct CoolingLaw {
@@ -0,0 +1,178 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Пакетный режим: много экземпляров в одном процессе ------------------------------
+// ./main batch <dir> решает все экземпляры каталога (*.csv и *.bin) независимыми последовательными отжигами
+// на пуле потоков. Сначала экземпляры читаются параллельно, затем задания раздаются по очередям потоков
+// по убыванию размера (крупные — первыми, как в LPT). Поток берёт задания из начала своей очереди,
+// а опустев, крадёт самое крупное из оставшихся у соседей — так ядра заняты до конца, даже когда
+// размеры экземпляров различаются на порядки. Сид экземпляра выводится из мастер-сида и его номера
+// в отсортированном списке файлов, поэтому результат не зависит от числа потоков и порядка выполнения.
+
+// Настройки одного отжига — те же, что у ./main file (значения по умолчанию как в main)
+struct BatchSettings {
+    string layout = "lists", init = "roundrobin", engine = "virtual", mutations = "uniform";
+    double T0 = 100.0;
+    int maxIter = 100000;
+    int noImproveLimit = 100;
+    int batchSize = 1;
+    bool batchBestOfK = true;
+    uint64_t masterSeed = 0;
+};
+
+struct BatchResult {
+    string path;
+    int N = 0, M = 0;
+    string cooling;
+    uint32_t seed = 0;
+    double initialK1 = 0, bestK1 = 0;
+    double lowerBound = 0; // нижняя граница K1 (lower_bound.h); bestK1 == lowerBound — доказанный оптимум
+    double seconds = 0;
+    string error; // непусто — экземпляр не прочитан или отжиг завершился ошибкой
+};
+
+// Файлы экземпляров каталога в лексикографическом порядке
+vector<string> collectInstances(const string &dir) {
+    vector<string> paths;
+    for (const auto &entry : filesystem::directory_iterator(dir)) {
+        if (!entry.is_regular_file()) continue;
+        string ext = entry.path().extension().string();
+        if (ext == ".csv" || ext == ".bin") paths.push_back(entry.path().string());
+    }
+    sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// Один отжиг экземпляра до нижней границы lowerBound: (K1 начального решения, K1 лучшего)
+pair<double, double> solveInstance(const InputData &data, const BatchSettings &cfg, uint32_t seed,
+                                   double lowerBound) {
+    int N = (int)data.w.size();
+    unique_ptr<Solution> initial = makeInitialSolution(cfg.layout, cfg.init, N, data.M, data.w);
+    unique_ptr<Solution> best;
+    if (cfg.engine == "lockstep") {
+        best = runLockstepAnnealing(*initial, data.cooling, cfg.T0, cfg.maxIter, cfg.noImproveLimit, seed, lowerBound,
+                                    cfg.mutations);
+    } else if (cfg.engine == "static") {
+        best = runStaticAnnealing(*initial, data.cooling, cfg.T0, cfg.maxIter, cfg.noImproveLimit, seed, lowerBound,
+                                  cfg.mutations);
+    } else {
+        SimulatedAnnealing sa(cfg.T0, cfg.maxIter, cfg.noImproveLimit, makeCoolingLaw(data.cooling, cfg.T0),
+                              makeMutation(cfg.mutations), seed);
+        sa.batchSize = cfg.batchSize;
+        sa.batchBestOfK = cfg.batchBestOfK;
+        sa.lowerBound = lowerBound;
+        best = sa.run(*initial);
+    }
+    return {initial->criteria(), best->criteria()};
+}
+
+// Очереди заданий пула с кражей работ: у каждого потока своя, под своим мьютексом.
+// Задания длинные (целый отжиг), поэтому мьютекса на очередь достаточно — очереди почти не конкурируют.
+struct WorkStealingQueues {
+    struct Queue {
+        mutex m;
+        deque<int> tasks;
+    };
+    vector<Queue> queues;
+
+    explicit WorkStealingQueues(int n) : queues(n) {}
+
+    void push(int owner, int task) {
+        lock_guard<mutex> lock(queues[owner].m);
+        queues[owner].tasks.push_back(task);
+    }
+
+    // своё задание, иначе украденное у соседа (начиная со следующего по кругу); false — работы не осталось
+    bool pop(int self, int &task) {
+        int n = (int)queues.size();
+        for (int k = 0; k < n; ++k) {
+            Queue &q = queues[(self + k) % n];
+            lock_guard<mutex> lock(q.m);
+            if (q.tasks.empty()) continue;
+            task = q.tasks.front(); // в начале очереди — самое крупное из оставшихся
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+};
+
+// Решить экземпляры paths на threads потоках; результаты — в порядке paths
+vector<BatchResult> runBatch(const vector<string> &paths, const BatchSettings &cfg, int threads) {
+    int count = (int)paths.size();
+    threads = max(1, min(threads, count));
+    vector<BatchResult> results(count);
+    vector<InputData> instances(count);
+
+    // ---- чтение всех экземпляров, параллельно ----
+    {
+        atomic<int> next{0};
+        vector<thread> pool;
+        for (int t = 0; t < threads; ++t)
+            pool.emplace_back([&] {
+                for (int i; (i = next.fetch_add(1)) < count;) {
+                    results[i].path = paths[i];
+                    try {
+                        instances[i] = readInstance(paths[i]);
+                        results[i].N = (int)instances[i].w.size();
+                        results[i].M = instances[i].M;
+                        results[i].cooling = instances[i].cooling;
+                    } catch (const exception &e) {
+                        results[i].error = e.what();
+                    }
+                }
+            });
+        for (auto &th : pool) th.join();
+    }
+
+    // ---- раздача заданий по убыванию размера, по кругу между очередями ----
+    vector<int> order;
+    for (int i = 0; i < count; ++i)
+        if (results[i].error.empty()) order.push_back(i);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return make_pair(results[a].N, results[a].M) > make_pair(results[b].N, results[b].M);
+    });
+    WorkStealingQueues queues(threads);
+    for (size_t k = 0; k < order.size(); ++k) queues.push(int(k % threads), order[k]);
+
+    // ---- отжиги ----
+    vector<thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back([&, t] {
+            int i;
+            while (queues.pop(t, i)) {
+                BatchResult &r = results[i];
+                r.seed = engineSeed(splitSeed(cfg.masterSeed, i));
+                auto start = chrono::steady_clock::now();
+                try {
+                    r.lowerBound = k1LowerBound(instances[i].w, instances[i].M);
+                    tie(r.initialK1, r.bestK1) = solveInstance(instances[i], cfg, r.seed, r.lowerBound);
+                } catch (const exception &e) {
+                    r.error = e.what();
+                }
+                r.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                instances[i] = InputData(); // длительности больше не нужны
+            }
+        });
+    for (auto &th : pool) th.join();
+    return results;
+}
+
+// Файл результатов: одна строка CSV на экземпляр
+void writeBatchResults(const string &filename, const vector<BatchResult> &results) {
+    ofstream out(filename);
+    if (!out.is_open())
+        throw runtime_error("Не удалось открыть файл для записи: " + filename);
+    out << "file,N,M,cooling,seed,initial_k1,best_k1,lower_bound,gap,seconds,status\n";
+    for (const auto &r : results) {
+        string status = r.error.empty() ? "ok" : r.error;
+        replace(status.begin(), status.end(), ',', ';');
+        out << r.path << "," << r.N << "," << r.M << "," << r.cooling << "," << r.seed << ","
+            << (long long)r.initialK1 << "," << (long long)r.bestK1 << "," << (long long)r.lowerBound << ","
+            << (long long)(r.bestK1 - r.lowerBound) << ","
+            << fixed << setprecision(4) << r.seconds << defaultfloat << "," << status << "\n";
+    }
+    if (!out)
+        throw runtime_error("Ошибка записи файла: " + filename);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Необязательные ключи командной строки ------------------------------
+// Ключи вида --name=value могут стоять в любом месте командной строки. extractOptions вырезает их
+// из argv, так что разбор режимов (default / manual / file) работает с оставшимися аргументами как раньше.
+struct Options {
+    map<string, string> values;
+
+    bool has(const string &key) const { return values.count(key) > 0; }
+
+    string get(const string &key, const string &def) const {
+        auto it = values.find(key);
+        return it == values.end() ? def : it->second;
+    }
+
+    long long getInt(const string &key, long long def) const {
+        auto it = values.find(key);
+        return it == values.end() ? def : stoll(it->second);
+    }
+
+    double getDouble(const string &key, double def) const {
+        auto it = values.find(key);
+        return it == values.end() ? def : stod(it->second);
+    }
+};
+
+Options extractOptions(int &argc, char **argv) {
+    Options opts;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--", 0) == 0) {
+            size_t eq = arg.find('=');
+            if (eq == string::npos) opts.values[arg.substr(2)] = "1";
+            else opts.values[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return opts;
+}
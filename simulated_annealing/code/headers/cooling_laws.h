@@ -37,4 +37,99 @@ class BoltzmannCooling : public CoolingLaw {
             if (iter == 0) return T0_;
             return T0_ * std::log(1 + iter) / (1 + iter);
         }
-    };
\ No newline at end of file
+    };
+    
+    // Постоянная температура: T = T0 (реплики в parallel tempering живут при фиксированной T)
+    class ConstantCooling : public CoolingLaw {
+    private:
+        double T0_;
+    public:
+        ConstantCooling(double T0) : T0_(T0) {}
+        
+        double nextTemperature(double currentT, int iter) override {
+            return T0_;
+        }
+    };
+
+// Закон охлаждения по имени (неизвестное имя — Cauchy)
+unique_ptr<CoolingLaw> makeCoolingLaw(const string &coolingType, double T0) {
+    if (coolingType == "Boltzmann") return make_unique<BoltzmannCooling>(T0);
+    if (coolingType == "Mixed") return make_unique<MixedCooling>(T0);
+    if (coolingType == "Constant") return make_unique<ConstantCooling>(T0);
+    return make_unique<CauchyCooling>(T0);
+}
+
+// ------------------------------ Таблица температур ------------------------------
+// Все законы выше зависят только от номера итерации, а каждый заход отжига начинается с T0 и iter = 0,
+// поэтому последовательность температур одна и та же: T[i] — температура после i итераций.
+// Таблица достраивается лениво по мере роста iter (эпохи, реплики и повторные run() читают готовое)
+// и ограничена MAX_SIZE элементами, дальше закон вызывается напрямую. Логарифм Больцмана и
+// смешанного закона считается один раз на итерацию за весь запуск, а не на каждом заходе.
+struct TemperatureTable {
+    static constexpr int MAX_SIZE = 1 << 18; // 2 МБ на движок
+
+    vector<double> T;
+
+    explicit TemperatureTable(double T0 = 0.0) : T(1, T0) {}
+
+    // температура после итерации iter при текущей currentT (== T[iter - 1] внутри таблицы)
+    template <class Law>
+    double next(Law &law, double currentT, int iter) {
+        if (iter < (int)T.size()) return T[iter];
+        double t = law.nextTemperature(currentT, iter);
+        if (iter == (int)T.size() && iter < MAX_SIZE) T.push_back(t);
+        return t;
+    }
+};
+
+
+// ------------------------------ Критерий Metropolis без exp ------------------------------
+// exp(-delta / T) >= u  <=>  delta <= -T * ln(u)  (T > 0). Экспонента заменена логарифмом случайного
+// числа, логарифм — табличным fastLog. Большинство ходов решается вовсе без трансцендентных функций
+// и без случайного числа:
+//   delta <= 0 (нейтральный ход)       — принимается всегда;
+//   delta > MAX_NEG_LOG_U * T          — отвергается всегда: u из uniform_real_distribution<double>
+//                                        на mt19937 не меньше 2^-64 (кроме u == 0), т.е. -ln u <= 44.37.
+// На поздних итерациях T мала и почти каждый ухудшающий ход отсекается вторым правилом.
+
+// ln(x) для x > 0: x = m * 2^e, m в [1, 2) режется по старшим 7 битам мантиссы на отрезки [c_k, c_k + 1/128),
+// ln m = ln c_k + ln(1 + r), r = m / c_k - 1 (|r| < 1/128) — ряд до r^5. Относительная ошибка < 1e-7.
+struct FastLogTable {
+    static constexpr int BITS = 7;
+    double lnC[1 << BITS], invC[1 << BITS];
+
+    FastLogTable() {
+        for (int k = 0; k < (1 << BITS); ++k) {
+            double c = 1.0 + double(k) / (1 << BITS);
+            lnC[k] = std::log(c);
+            invC[k] = 1.0 / c;
+        }
+    }
+};
+
+inline double fastLog(double x) {
+    static const FastLogTable table;
+    if (!(x > 0.0)) return x == 0.0 ? -numeric_limits<double>::infinity() : numeric_limits<double>::quiet_NaN();
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int e = int(bits >> 52) - 1023; // знак у x > 0 нулевой
+    if (e == -1023) return std::log(x); // денормализованные числа — редкость, считаем точно
+    int k = int(bits >> (52 - FastLogTable::BITS)) & ((1 << FastLogTable::BITS) - 1);
+    bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+    double r = m * table.invC[k] - 1.0;
+    double lnR = r * (1.0 - r * (0.5 - r * (1.0 / 3 - r * (0.25 - r * 0.2))));
+    return e * 0.6931471805599453 + table.lnC[k] + lnR;
+}
+
+constexpr double MAX_NEG_LOG_U = 44.37; // > 64 ln 2
+
+// Принять ход, ухудшающий K1 на delta, при температуре T. Случайное число тянется из rng только
+// когда исход действительно случаен.
+template <class Rng>
+inline bool metropolisAccept(double delta, double T, Rng &rng, uniform_real_distribution<double> &unit) {
+    if (delta <= 0.0) return true;
+    if (delta > MAX_NEG_LOG_U * T) return false;
+    return delta <= -T * fastLog(unit(rng));
+}
@@ -1,6 +1,10 @@
 # pragma once
 
 #include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
 // ------------------------------ Генератор входных данных ------------------------------
@@ -17,48 +21,212 @@ struct InputData {
     int N, M;
     string cooling;
     int minW, maxW;
-    vector<int> w;
+    JobDurations w; // общая таблица длительностей — решения экземпляра ссылаются на неё без копии
 };
 
-InputData readCSV(const string &filename) {
-    InputData data;
-    ifstream fin(filename);
-    if (!fin.is_open())
-        throw runtime_error("Не удалось открыть файл: " + filename);
+// Файл, отображённый в память только для чтения. Пустой файл даёт size == 0 и data == nullptr.
+struct MappedFile {
+    const char *data = nullptr;
+    size_t size = 0;
+
+    explicit MappedFile(const string &filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw runtime_error("Не удалось открыть файл: " + filename);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw runtime_error("Не удалось прочитать размер файла: " + filename);
+        }
+        size = st.st_size;
+        if (size > 0) {
+            void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw runtime_error("Не удалось отобразить файл в память: " + filename);
+            }
+            ::madvise(p, size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(p);
+        }
+        ::close(fd); // отображение живёт и без дескриптора
+    }
 
-    string line;
+    ~MappedFile() {
+        if (data) ::munmap(const_cast<char *>(data), size);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+};
+
+// Разбор CSV прямо по отображённому файлу: поля читаются from_chars без копирования строк,
+// длительности пишутся в заранее выделенный по N выровненный массив, который и становится таблицей JobDurations.
+struct CsvCursor {
+    const char *p, *end;
+
+    bool atLineEnd() const { return p == end || *p == '\n' || *p == '\r'; }
+
+    void skipSpaces() {
+        while (p != end && (*p == ' ' || *p == '\t')) ++p;
+    }
+
+    // следующее поле строки как есть (без запятой); курсор встаёт за запятую
+    string_view field() {
+        const char *b = p;
+        while (p != end && *p != ',' && *p != '\n' && *p != '\r') ++p;
+        string_view f(b, p - b);
+        if (p != end && *p == ',') ++p;
+        return f;
+    }
+
+    // следующее поле как целое; false — поле пустое
+    bool number(int &out, const char *what) {
+        skipSpaces();
+        if (p != end && *p == ',') { ++p; return false; }
+        if (atLineEnd()) return false;
+        auto [q, ec] = from_chars(p, end, out);
+        if (ec != errc())
+            throw runtime_error(string("Ошибка: не удалось прочитать число (") + what + ")");
+        p = q;
+        skipSpaces();
+        if (p != end && *p == ',') ++p;
+        else if (!atLineEnd())
+            throw runtime_error(string("Ошибка: лишние символы после числа (") + what + ")");
+        return true;
+    }
+
+    // перейти к началу следующей строки; false — строк больше нет
+    bool nextLine() {
+        while (p != end && *p != '\n') ++p;
+        if (p == end) return false;
+        ++p;
+        return true;
+    }
+};
+
+// Общая проверка заголовка экземпляра (CSV и двоичного): M процессоров на N работ.
+// M > N допустимо — лишние процессоры остаются пустыми (K1Index ведёт их через nonEmpty)
+void checkInstanceShape(const InputData &data) {
+    if (data.N < 0)
+        throw runtime_error("Ошибка: N должно быть неотрицательным (N=" + to_string(data.N) + ")");
+    if (data.M <= 0)
+        throw runtime_error("Ошибка: M должно быть положительным (M=" + to_string(data.M) + ")");
+}
+
+InputData readCSV(const MappedFile &file) {
+    InputData data;
+    CsvCursor cur{file.data, file.data + file.size};
 
     // ---- первая строка ----
-    if (!getline(fin, line))
+    if (file.size == 0)
         throw runtime_error("Ошибка: файл пустой");
     {
-        stringstream ss(line);
-        string field;
-        vector<string> parts;
-        while (getline(ss, field, ',')) parts.push_back(field);
-        if (parts.size() < 5)
-            throw runtime_error("Ошибка: первая строка должна содержать N,M,cooling,minW,maxW");
-        data.N = stoi(parts[0]);
-        data.M = stoi(parts[1]);
-        data.cooling = parts[2];
-        data.minW = stoi(parts[3]);
-        data.maxW = stoi(parts[4]);
+        int *ints[] = {&data.N, &data.M, nullptr, &data.minW, &data.maxW};
+        for (int k = 0; k < 5; ++k) {
+            if (cur.atLineEnd())
+                throw runtime_error("Ошибка: первая строка должна содержать N,M,cooling,minW,maxW");
+            if (!ints[k]) {
+                data.cooling = string(cur.field());
+            } else if (!cur.number(*ints[k], "первая строка")) {
+                throw runtime_error("Ошибка: первая строка должна содержать N,M,cooling,minW,maxW");
+            }
+        }
+        checkInstanceShape(data);
     }
 
     // ---- вторая строка ----
-    if (!getline(fin, line))
+    if (!cur.nextLine() || cur.p == cur.end)
         throw runtime_error("Ошибка: отсутствует строка с длительностями работ");
     {
-        stringstream ss(line);
-        string value;
-        while (getline(ss, value, ',')) {
-            if (!value.empty())
-                data.w.push_back(stoi(value));
+        // N из заголовка не доверяем больше, чем позволяет файл: на длительность — хотя бы цифра и запятая
+        AlignedInts w(min<size_t>(data.N, (size_t)(cur.end - cur.p) / 2 + 1));
+        size_t count = 0;
+        int value;
+        while (!cur.atLineEnd()) {
+            if (!cur.number(value, "длительность работы")) continue;
+            if (count < w.size()) w[count] = value;
+            else w.push_back(value);
+            ++count;
         }
-        if ((int)data.w.size() != data.N)
-            cerr << "⚠️ Предупреждение: количество длительностей (" << data.w.size()
+        w.resize(count);
+        if ((int)w.size() != data.N)
+            cerr << "⚠️ Предупреждение: количество длительностей (" << w.size()
                  << ") не совпадает с N=" << data.N << "\n";
+        data.w = JobDurations(move(w));
     }
 
     return data;
-}
\ No newline at end of file
+}
+
+InputData readCSV(const string &filename) {
+    return readCSV(MappedFile(filename));
+}
+
+
+// ----------------------------- Двоичный формат экземпляра ---------------------------------
+// Заголовок фиксированного размера (64 байта) и сразу за ним N длительностей int32 подряд.
+// Порядок байт — родной для машины (x86 / ARM — little-endian); файл не переносится на big-endian.
+struct BinaryInstanceHeader {
+    char magic[8];     // "SAINST01"
+    int32_t N, M;
+    int32_t minW, maxW;
+    char cooling[32];  // закон охлаждения, дополнен нулями
+    int32_t reserved[2];
+};
+static_assert(sizeof(BinaryInstanceHeader) == 64, "заголовок двоичного экземпляра — 64 байта");
+
+const char BINARY_INSTANCE_MAGIC[8] = {'S', 'A', 'I', 'N', 'S', 'T', '0', '1'};
+
+bool isBinaryInstance(const MappedFile &file) {
+    return file.size >= sizeof(BinaryInstanceHeader) &&
+           memcmp(file.data, BINARY_INSTANCE_MAGIC, sizeof(BINARY_INSTANCE_MAGIC)) == 0;
+}
+
+// Чтение двоичного экземпляра: разбора нет, длительности копируются одним memcpy
+// прямо в выровненную таблицу JobDurations — других копий по N чисел нет
+InputData readBinary(const MappedFile &file) {
+    if (!isBinaryInstance(file))
+        throw runtime_error("Ошибка: это не двоичный экземпляр (нет сигнатуры SAINST01)");
+    BinaryInstanceHeader h;
+    memcpy(&h, file.data, sizeof(h));
+    InputData data;
+    data.N = h.N;
+    data.M = h.M;
+    data.minW = h.minW;
+    data.maxW = h.maxW;
+    checkInstanceShape(data);
+    if (file.size < sizeof(h) + size_t(h.N) * sizeof(int32_t))
+        throw runtime_error("Ошибка: двоичный экземпляр обрезан");
+
+    data.cooling = string(h.cooling, strnlen(h.cooling, sizeof(h.cooling)));
+    AlignedInts w(h.N);
+    memcpy(w.data(), file.data + sizeof(h), size_t(h.N) * sizeof(int32_t));
+    data.w = JobDurations(move(w));
+    return data;
+}
+
+void writeBinary(const string &filename, const InputData &data) {
+    BinaryInstanceHeader h{};
+    memcpy(h.magic, BINARY_INSTANCE_MAGIC, sizeof(h.magic));
+    h.N = data.w.size();
+    h.M = data.M;
+    h.minW = data.minW;
+    h.maxW = data.maxW;
+    if (data.cooling.size() >= sizeof(h.cooling))
+        throw runtime_error("Ошибка: слишком длинное имя закона охлаждения: " + data.cooling);
+    memcpy(h.cooling, data.cooling.data(), data.cooling.size());
+
+    ofstream fout(filename, ios::binary);
+    if (!fout.is_open())
+        throw runtime_error("Не удалось открыть файл для записи: " + filename);
+    fout.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    fout.write(reinterpret_cast<const char *>(data.w.data()), data.w.size() * sizeof(int32_t));
+    if (!fout)
+        throw runtime_error("Ошибка записи файла: " + filename);
+}
+
+// Экземпляр из файла любого из двух форматов: двоичный узнаётся по сигнатуре, иначе CSV
+InputData readInstance(const string &filename) {
+    MappedFile file(filename);
+    return isBinaryInstance(file) ? readBinary(file) : readCSV(file);
+}
@@ -0,0 +1,150 @@
+using namespace std;
+
+// ------------------------------ Плоская раскладка расписания ------------------------------
+// То же расписание, что и ScheduleSolution, но все работы лежат в одном непрерывном массиве.
+// Процессору j принадлежит сегмент jobs[start[j] .. start[j+1]); занято первые cnt[j] ячеек,
+// хвост сегмента — зазор под вставки. Когда зазора не хватает, массив раскладывается заново.
+struct FlatScheduleSolution : Solution {
+    int N; // число работ
+    int M; // число процессоров
+    JobDurations w;    // длительности работ (общая таблица экземпляра)
+    vector<int> jobs;  // работы всех процессоров подряд (с зазорами)
+    vector<int> start; // start[j] — начало сегмента процессора j, start[M] == jobs.size()
+    vector<int> cnt;   // cnt[j] — число работ на процессоре j
+    K1Index index;
+
+    FlatScheduleSolution() = default;
+
+    FlatScheduleSolution(int N_, int M_, JobDurations w_) : N(N_), M(M_), w(move(w_)) {
+        // та же стартовая раздача round-robin, что и у ScheduleSolution
+        vector<vector<int>> lists(M);
+        for (int i = 0; i < N; ++i) lists[i % M].push_back(i);
+        layout(lists);
+    }
+
+    explicit FlatScheduleSolution(const ScheduleSolution &s) : N(s.N), M(s.M), w(s.w) {
+        layout(s.jobLists);
+    }
+
+    unique_ptr<Solution> clone() const override {
+        return make_unique<FlatScheduleSolution>(*this);
+    }
+
+    void copyFrom(const Solution &other) override {
+        *this = dynamic_cast<const FlatScheduleSolution &>(other);
+    }
+
+    double criteria() const override {
+        return index.k1();
+    }
+
+    // K1 полным проходом по всем работам
+    double fullCriteria() const {
+        AlignedInts loads, heads;
+        measure(loads, heads);
+        return K1Index::k1Of(loads, heads);
+    }
+
+    string toString() const override {
+        ostringstream oss;
+        oss << "Schedule (M=" << M << ", N=" << N << "): (K1)=" << criteria() << "\n";
+        return oss.str();
+    }
+
+    int cpuSize(int p) const { return cnt[p]; }
+    int job(int p, int i) const { return jobs[start[p] + i]; }
+
+    // переместить работу из (p_from, idx_in_from) в (p_to, pos). Возвращает новое K1.
+    double moveJob(int p_from, int idx_in_from, int p_to, int pos) {
+        if (p_from < 0 || p_from >= M || p_to < 0 || p_to >= M) return criteria();
+        if (idx_in_from < 0 || idx_in_from >= cnt[p_from]) return criteria();
+        int *seg = &jobs[start[p_from]];
+        int jb = seg[idx_in_from];
+        copy(seg + idx_in_from + 1, seg + cnt[p_from], seg + idx_in_from);
+        --cnt[p_from];
+
+        if (cnt[p_to] == start[p_to + 1] - start[p_to]) relayout();
+        if (pos < 0) pos = 0;
+        if (pos > cnt[p_to]) pos = cnt[p_to];
+        seg = &jobs[start[p_to]];
+        copy_backward(seg + pos, seg + cnt[p_to], seg + cnt[p_to] + 1);
+        seg[pos] = jb;
+        ++cnt[p_to];
+
+        if (p_from != p_to) {
+            refreshCpu(p_from, index.load[p_from] - w[jb]);
+            refreshCpu(p_to, index.load[p_to] + w[jb]);
+        } else if (idx_in_from == 0 || pos == 0) {
+            refreshCpu(p_from, index.load[p_from]);
+        }
+        return criteria();
+    }
+
+    // swap двух работ (p1,i1) и (p2,i2). Возвращает новое K1.
+    double swapJobs(int p1, int i1, int p2, int i2) {
+        if (p1 < 0 || p1 >= M || p2 < 0 || p2 >= M) return criteria();
+        if (i1 < 0 || i1 >= cnt[p1]) return criteria();
+        if (i2 < 0 || i2 >= cnt[p2]) return criteria();
+        int &a = jobs[start[p1] + i1];
+        int &b = jobs[start[p2] + i2];
+        std::swap(a, b);
+
+        if (p1 != p2) {
+            int diff = w[a] - w[b];
+            if (diff == 0) return criteria(); // равные длительности: загрузки и первые работы те же
+            refreshCpu(p1, index.load[p1] + diff);
+            refreshCpu(p2, index.load[p2] - diff);
+        } else if (i1 == 0 || i2 == 0) {
+            refreshCpu(p1, index.load[p1]);
+        }
+        return criteria();
+    }
+
+private:
+    // запас под вставки на каждый процессор при раскладке
+    int slack() const { return max(8, N / max(1, M) / 4); }
+
+    void layout(const vector<vector<int>> &lists) {
+        cnt.assign(M, 0);
+        start.assign(M + 1, 0);
+        int gap = slack();
+        for (int j = 0; j < M; ++j) {
+            cnt[j] = lists[j].size();
+            start[j + 1] = start[j] + cnt[j] + gap;
+        }
+        jobs.assign(start[M], -1);
+        for (int j = 0; j < M; ++j) copy(lists[j].begin(), lists[j].end(), jobs.begin() + start[j]);
+
+        AlignedInts loads, heads;
+        measure(loads, heads);
+        index.build(move(loads), move(heads));
+    }
+
+    // загрузки и первые работы процессоров: сегменты непрерывны, сбор w[job] векторный
+    void measure(AlignedInts &loads, AlignedInts &heads) const {
+        loads.assign(M, 0);
+        heads.assign(M, K1Index::NO_HEAD);
+        for (int j = 0; j < M; ++j) {
+            if (cnt[j] == 0) continue;
+            loads[j] = simd::gatherSum(w.data(), jobs.data() + start[j], cnt[j]);
+            heads[j] = w[jobs[start[j]]];
+        }
+    }
+
+    // раздвинуть сегменты, вернув каждому процессору свежий зазор. O(N + M), случается редко.
+    void relayout() {
+        int gap = slack();
+        vector<int> newStart(M + 1, 0);
+        for (int j = 0; j < M; ++j) newStart[j + 1] = newStart[j] + cnt[j] + gap;
+        vector<int> newJobs(newStart[M], -1);
+        for (int j = 0; j < M; ++j)
+            copy(jobs.begin() + start[j], jobs.begin() + start[j] + cnt[j], newJobs.begin() + newStart[j]);
+        jobs.swap(newJobs);
+        start.swap(newStart);
+    }
+
+    void refreshCpu(int p, int newLoad) {
+        int h = cnt[p] == 0 ? K1Index::NO_HEAD : w[jobs[start[p]]];
+        index.set(p, newLoad, h);
+    }
+};
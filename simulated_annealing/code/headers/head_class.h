@@ -5,13 +5,23 @@ struct SimulatedAnnealing {
     int maxIterations; // макс. число итераций (внешних шагов)
     int noImproveLimit; // число итераций без улучшения для остановки (K = 100 по ТЗ)
     unique_ptr<CoolingLaw> cooling;
-    shared_ptr<Mutation> mutation;
+    shared_ptr<Mutation> mutation; // у мутации с состоянием — своя копия движка (Mutation::forEngine)
     mt19937 rng;
+    uniform_real_distribution<double> unit{0.0, 1.0}; // Metropolis-тест берёт числа из своего rng, не из rand()
+    bool inPlace = true; // мутировать одно решение и откатывать отвергнутые ходы вместо clone() на итерацию
+    int batchSize = 1;         // кандидатов на шаг (1 — обычный отжиг, >1 — batchedMove, только для inPlace)
+    bool batchBestOfK = true;  // true — Metropolis для лучшего из K; false — первый принятый по порядку
+    vector<MoveRecord> batchMoves;   // буферы batchedMove, переиспользуются между шагами
+    vector<double> batchCriteria;
+    double lowerBound = 0;           // K1 меньше не бывает (см. lower_bound.h): дошли — оптимум, отжиг останавливается
+    SolutionPool pool;               // отвергнутые кандидаты run() без inPlace — память для следующих копий
+    TemperatureTable temperatures;   // T после i итераций, общая для всех заходов отжига
+    SA_TM(shared_ptr<EngineTelemetry> tm = telemetry().add();) // счётчики и трасса (только с -DSA_TELEMETRY)
 
     SimulatedAnnealing(double T0_, int maxIter_, int noImproveLimit_,
                        unique_ptr<CoolingLaw> cooling_, shared_ptr<Mutation> mutation_, uint32_t seed = 0)
         : T0(T0_), maxIterations(maxIter_), noImproveLimit(noImproveLimit_),
-          cooling(move(cooling_)), mutation(mutation_)
+          cooling(move(cooling_)), mutation(mutation_->forEngine(mutation_)), temperatures(T0_)
     {
         // Надо ли вот это?
         if (seed == 0) {
@@ -23,6 +33,8 @@ struct SimulatedAnnealing {
 
     // Запуск ИО. initialSolution должен быть валидной (и будет скопирован).
     unique_ptr<Solution> run(const Solution &initial) {
+        if (inPlace) return runInPlace(initial);
+
         // рабочие копии
         //unique_ptr<Solution> current = initial.clone();
         unique_ptr<Solution> best_solution = initial.clone();
@@ -35,12 +47,13 @@ struct SimulatedAnnealing {
         int iter = 0;
         int noImprove = 0;
 
-        while (iter < maxIterations && noImprove < noImproveLimit) {
+        while (iter < maxIterations && noImprove < noImproveLimit && best_solution_criteria > lowerBound) {
             //if (iter % 1000 == 0) std::cout << iter << std::endl;
             // создаём кандидата
-            unique_ptr<Solution> new_solution = best_solution->clone();
+            double before = best_solution->criteria();
+            unique_ptr<Solution> new_solution = pool.copyOf(*best_solution);
             // применяем мутацию (in-place)
-            mutation->apply(*new_solution, rng);
+            MoveRecord rec = mutation->apply(*new_solution, rng);
 
             double new_solution_criteria = new_solution->criteria();
             //double delta = new_solution_criteria - current_criteria;
@@ -53,7 +66,8 @@ struct SimulatedAnnealing {
 
                 best_solution_criteria = new_solution_criteria;
                 noImprove = 0;
-                best_solution = move(new_solution);
+                mutation->accepted(rec, before - new_solution_criteria);
+                pool.recycle(exchange(best_solution, move(new_solution)));
 
 
             } else {
@@ -61,18 +75,20 @@ struct SimulatedAnnealing {
                 double acceptanceProbability = std::exp(-(new_solution_criteria - best_solution_criteria) / T);
                 
                 // std::cout << acceptanceProbability << ' ' << prob << std::endl;
-                if (acceptanceProbability >= static_cast<double>(rand()) / RAND_MAX)
+                if (acceptanceProbability >= unit(rng))
                 {
                     // Принимаем новое решение
                     
                     noImprove = 0;
-                    best_solution = move(new_solution);
+                    if (new_solution_criteria < before) mutation->accepted(rec, before - new_solution_criteria);
+                    pool.recycle(exchange(best_solution, move(new_solution)));
 
                 }
                 else
                 {
                     // Не принимаем новое решение
                     noImprove++;
+                    pool.recycle(move(new_solution));
                 }
             }
 
@@ -83,4 +99,104 @@ struct SimulatedAnnealing {
 
         return best_solution;
     }
+
+    // Тот же цикл без копий: мутация применяется к единственному решению,
+    // отвергнутый ход откатывается через Mutation::undo. Итерация ничего не аллоцирует.
+    unique_ptr<Solution> runInPlace(const Solution &initial) {
+        unique_ptr<Solution> current = initial.clone();
+        // как и в run(): эталон для сравнения обновляется только при улучшении
+        double best_solution_criteria = current->criteria();
+
+        double T = T0;
+        int iter = 0;
+        int noImprove = 0;
+        SA_TM(TmStopwatch sw;)
+
+        while (iter < maxIterations && noImprove < noImproveLimit && best_solution_criteria > lowerBound) {
+            if (batchSize > 1) {
+                if (batchedMove(*current, best_solution_criteria, T)) noImprove = 0;
+                else noImprove++;
+                ++iter;
+                T = temperatures.next(*cooling, T, iter);
+                SA_TM(tm->tick(T, *current, batchSize);)
+                continue;
+            }
+
+            // нейтральный ход (Mutation::applyFiltered) не применён и применяется, только если принят
+            double before = current->criteria();
+            MoveRecord rec = mutation->applyFiltered(*current, rng);
+            SA_TM(if (rec.neutral) tm->neutral++;)
+            double new_criteria = current->criteria();
+
+            if (new_criteria < best_solution_criteria) {
+                best_solution_criteria = new_criteria;
+                mutation->accepted(rec, before - new_criteria);
+                noImprove = 0;
+                SA_TM(tm->improving++;)
+            } else if (metropolisAccept(new_criteria - best_solution_criteria, T, rng, unit)) {
+                // Принимаем ход — он уже применён (нейтральный применяем сейчас)
+                if (rec.neutral) mutation->redo(*current, rec);
+                if (new_criteria < before) mutation->accepted(rec, before - new_criteria);
+                noImprove = 0;
+                SA_TM(tm->acceptedWorse++;)
+            } else {
+                if (!rec.neutral) mutation->undo(*current, rec);
+                noImprove++;
+                SA_TM(tm->rejected++;)
+            }
+
+            ++iter;
+            T = temperatures.next(*cooling, T, iter);
+            SA_TM(tm->tick(T, *current);)
+        }
+
+        SA_TM(tm->annealSeconds += sw.lap();)
+        return current;
+    }
+
+    // Шаг с batchSize кандидатами из одного и того же решения: каждый применяется, оценивается
+    // и сразу откатывается, выбранный применяется заново через Mutation::redo.
+    // Возвращает true, только если эталон улучшился: среди K кандидатов почти всегда есть
+    // нейтральный, и счёт по принятым ходам не дал бы отжигу остановиться по noImproveLimit.
+    bool batchedMove(Solution &current, double &reference, double T) {
+        double before = current.criteria();
+        batchMoves.clear();
+        batchCriteria.clear();
+        for (int k = 0; k < batchSize; ++k) {
+            MoveRecord rec = mutation->apply(current, rng);
+            batchCriteria.push_back(current.criteria());
+            mutation->undo(current, rec);
+            batchMoves.push_back(rec);
+        }
+
+        bool improved = false;
+        auto accepts = [&](double c) {
+            if (c < reference) { reference = c; improved = true; SA_TM(tm->improving++;) return true; }
+            bool ok = metropolisAccept(c - reference, T, rng, unit);
+            SA_TM(if (ok) tm->acceptedWorse++;)
+            return ok;
+        };
+
+        if (batchBestOfK) {
+            int b = min_element(batchCriteria.begin(), batchCriteria.end()) - batchCriteria.begin();
+            bool ok = accepts(batchCriteria[b]);
+            if (ok) acceptBatched(current, batchMoves[b], batchCriteria[b], before);
+            SA_TM(if (!ok) tm->rejected++;)
+            return improved;
+        }
+        for (int k = 0; k < batchSize; ++k) {
+            if (accepts(batchCriteria[k])) {
+                acceptBatched(current, batchMoves[k], batchCriteria[k], before);
+                return improved;
+            }
+        }
+        SA_TM(tm->rejected++;)
+        return improved;
+    }
+
+    // выбранный кандидат batchedMove применяется заново; выигрыш засчитывается его оператору
+    void acceptBatched(Solution &current, const MoveRecord &rec, double c, double before) {
+        mutation->redo(current, rec);
+        if (c < before) mutation->accepted(rec, before - c);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Конструктивные начальные расписания ------------------------------
+// Вместо round-robin отжиг может стартовать с расписания, построенного жадно:
+//   roundrobin — работа i на процессор i % M (как раньше);
+//   greedy     — работы в исходном порядке, каждая на наименее загруженный процессор (куча), O(N log M);
+//   lpt        — то же, но работы по убыванию длительности (Longest Processing Time), O(N log N);
+//   k1         — под критерий K1 = Tmax - Tmin: первыми на процессоры встают M самых длинных работ
+//                (Tmin — минимальная первая работа, так она максимальна; выбор nth_element, O(N)),
+//                остальные раздаются greedy в исходном порядке, O(N log M).
+// Порядок работ на процессоре — порядок раздачи, поэтому у lpt и k1 первой стоит самая длинная работа.
+
+// Жадная раздача работ order[from..] на наименее загруженные процессоры
+void assignToLeastLoaded(const vector<int> &order, size_t from, const JobDurations &w,
+                         vector<vector<int>> &lists, vector<long long> &load) {
+    using Cpu = pair<long long, int>; // (загрузка, процессор)
+    priority_queue<Cpu, vector<Cpu>, greater<Cpu>> heap;
+    for (int j = 0; j < (int)lists.size(); ++j) heap.push({load[j], j});
+    for (size_t k = from; k < order.size(); ++k) {
+        auto [l, j] = heap.top();
+        heap.pop();
+        lists[j].push_back(order[k]);
+        load[j] = l + w[order[k]];
+        heap.push({load[j], j});
+    }
+}
+
+// Раздача работ по процессорам выбранным способом
+vector<vector<int>> initialAssignment(const string &kind, int N, int M, const JobDurations &w) {
+    vector<vector<int>> lists(M);
+    vector<long long> load(M, 0);
+    vector<int> order(N);
+    iota(order.begin(), order.end(), 0);
+
+    if (kind == "greedy") {
+        assignToLeastLoaded(order, 0, w, lists, load);
+    } else if (kind == "lpt") {
+        stable_sort(order.begin(), order.end(), [&](int a, int b) { return w[a] > w[b]; });
+        assignToLeastLoaded(order, 0, w, lists, load);
+    } else if (kind == "k1") {
+        int heads = min(N, M);
+        // M самых длинных работ — в начало order, по одной на процессор
+        nth_element(order.begin(), order.begin() + heads, order.end(),
+                    [&](int a, int b) { return w[a] > w[b]; });
+        vector<char> isHead(N, 0);
+        for (int j = 0; j < heads; ++j) {
+            lists[j].push_back(order[j]);
+            load[j] = w[order[j]];
+            isHead[order[j]] = 1;
+        }
+        // остальные — в исходном порядке: проход по номерам за O(N) вместо сортировки хвоста
+        size_t k = heads;
+        for (int i = 0; i < N; ++i)
+            if (!isHead[i]) order[k++] = i;
+        assignToLeastLoaded(order, heads, w, lists, load);
+    } else {
+        for (int i = 0; i < N; ++i) lists[i % M].push_back(i);
+    }
+    return lists;
+}
+
+// Начальное решение в нужной раскладке
+unique_ptr<Solution> makeInitialSolution(const string &layout, const string &kind,
+                                         int N, int M, const JobDurations &w) {
+    ScheduleSolution lists(N, M, w, initialAssignment(kind, N, M, w));
+    if (layout == "flat") return make_unique<FlatScheduleSolution>(lists);
+    return make_unique<ScheduleSolution>(move(lists));
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Длительности работ экземпляра ------------------------------
+// Длительности не меняются за всё решение, поэтому лежат один раз — в неизменяемой выровненной
+// таблице, на которую ссылаются все решения экземпляра. clone() и copyFrom() копируют только ссылку:
+// кандидаты, пул, рабочие копии потоков и снимки эпох больше не несут по N чисел каждый.
+// Таблица остаётся 32-битной: векторный сбор загрузок (simd::gatherSum, сбор в lockstep) читает int.
+class JobDurations {
+    shared_ptr<const AlignedInts> table;
+    const int *ptr = nullptr; // table->data(): w[i] — одно обращение, без разыменования shared_ptr
+    int count = 0;
+
+public:
+    JobDurations() = default;
+
+    // новая таблица — один раз на экземпляр; явное, чтобы случайная копия vector<int> не создавала ещё одну
+    explicit JobDurations(const vector<int> &w)
+        : table(make_shared<const AlignedInts>(w.begin(), w.end())), ptr(table->data()), count(w.size()) {}
+    // таблица из уже выровненного массива (чтение экземпляра пишет прямо в него) — без копии
+    explicit JobDurations(AlignedInts &&w)
+        : table(make_shared<const AlignedInts>(move(w))), ptr(table->data()), count(table->size()) {}
+
+    JobDurations(const JobDurations &) = default;
+    JobDurations(JobDurations &&) = default;
+    JobDurations &operator=(JobDurations &&) = default;
+
+    // copyFrom() решений того же экземпляра: таблица та же, счётчик ссылок не трогаем
+    JobDurations &operator=(const JobDurations &other) {
+        if (table != other.table) {
+            table = other.table;
+            ptr = other.ptr;
+            count = other.count;
+        }
+        return *this;
+    }
+
+    int operator[](int i) const { return ptr[i]; }
+    const int *data() const { return ptr; }
+    size_t size() const { return count; }
+    const int *begin() const { return ptr; }
+    const int *end() const { return ptr + count; }
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Индекс для инкрементального пересчёта K1 ------------------------------
+// K1 = Tmax - Tmin, где Tmax — максимальная загрузка процессора, а Tmin — минимальная
+// длительность первой работы среди непустых процессоров (моменты завершения на одном
+// процессоре только растут). Поэтому достаточно хранить по два числа на процессор.
+
+// Дерево отрезков над M листьями: в каждой вершине лежит лучшее значение поддерева
+// и индекс листа, на котором оно достигается. Обновление — O(log M), запрос — O(1).
+template <class Better>
+struct ExtremumTree {
+    int size = 1;       // число листьев (степень двойки >= M)
+    int neutral = 0;    // значение для пустых листьев
+    vector<int> val;    // val[v] — лучшее значение в поддереве v
+    vector<int> arg;    // arg[v] — индекс листа с этим значением
+
+    template <class V>
+    void build(const V &a, int neutral_) {
+        neutral = neutral_;
+        size = 1;
+        while (size < (int)a.size()) size <<= 1;
+        val.assign(2 * size, neutral);
+        arg.assign(2 * size, 0);
+        for (int i = 0; i < size; ++i) {
+            if (i < (int)a.size()) val[size + i] = a[i];
+            arg[size + i] = i;
+        }
+        for (int v = size - 1; v > 0; --v) pull(v);
+    }
+
+    void update(int i, int value) {
+        int v = size + i;
+        val[v] = value;
+        for (v >>= 1; v > 0; v >>= 1) pull(v);
+    }
+
+    int top() const { return val[1]; }
+    int topIndex() const { return arg[1]; }
+
+private:
+    void pull(int v) {
+        int c = Better()(val[2 * v + 1], val[2 * v]) ? 2 * v + 1 : 2 * v;
+        val[v] = val[c];
+        arg[v] = arg[c];
+    }
+};
+
+// Загрузки и первые работы всех процессоров + два дерева экстремумов над ними
+struct K1Index {
+    static constexpr int NO_LOAD = numeric_limits<int>::min(); // пустой процессор не влияет на Tmax
+    static constexpr int NO_HEAD = numeric_limits<int>::max(); // и на Tmin
+
+    AlignedInts load; // load[j] — суммарная длительность работ на процессоре j
+    AlignedInts head; // head[j] — длительность первой работы на процессоре j (NO_HEAD если пусто)
+    ExtremumTree<greater<int>> maxLoad;
+    ExtremumTree<less<int>> minHead;
+    vector<int> nonEmpty; // непустые процессоры по возрастанию номера; меняется, только когда процессор пустеет или заполняется
+
+    // загрузки и первые работы процессоров по jobLists (векторный сбор w[job])
+    static void measure(const vector<vector<int>> &jobLists, const int *w,
+                        AlignedInts &loads, AlignedInts &heads) {
+        int M = jobLists.size();
+        loads.assign(M, 0);
+        heads.assign(M, NO_HEAD);
+        for (int j = 0; j < M; ++j) {
+            if (jobLists[j].empty()) continue;
+            loads[j] = simd::gatherSum(w, jobLists[j].data(), jobLists[j].size());
+            heads[j] = w[jobLists[j].front()];
+        }
+    }
+
+    // K1 по готовым загрузкам и первым работам — векторная редукция, без деревьев
+    static double k1Of(const AlignedInts &loads, const AlignedInts &heads) {
+        int Tmax, Tmin;
+        simd::loadHeadExtrema(loads.data(), heads.data(), loads.size(), NO_HEAD, Tmax, Tmin);
+        if (Tmin == NO_HEAD) return 0.0;
+        return double(Tmax - Tmin);
+    }
+
+    // полная перестройка по jobLists: O(N + M)
+    void build(const vector<vector<int>> &jobLists, const int *w) {
+        AlignedInts loads, heads;
+        measure(jobLists, w, loads, heads);
+        build(move(loads), move(heads));
+    }
+
+    // перестройка по готовым загрузкам и первым работам
+    void build(AlignedInts loads, AlignedInts heads) {
+        load = move(loads);
+        head = move(heads);
+        AlignedInts loadLeaf(load.size(), NO_LOAD);
+        for (size_t j = 0; j < load.size(); ++j)
+            if (head[j] != NO_HEAD) loadLeaf[j] = load[j];
+        maxLoad.build(loadLeaf, NO_LOAD);
+        minHead.build(head, NO_HEAD);
+        nonEmpty.clear();
+        for (size_t j = 0; j < head.size(); ++j)
+            if (head[j] != NO_HEAD) nonEmpty.push_back(j);
+    }
+
+    // процессор j изменился: новая загрузка и первая работа (NO_HEAD если опустел)
+    void set(int j, int newLoad, int newHead) {
+        if ((head[j] == NO_HEAD) != (newHead == NO_HEAD)) {
+            auto it = lower_bound(nonEmpty.begin(), nonEmpty.end(), j);
+            if (newHead == NO_HEAD) nonEmpty.erase(it);
+            else nonEmpty.insert(it, j);
+        }
+        load[j] = newLoad;
+        head[j] = newHead;
+        maxLoad.update(j, newHead == NO_HEAD ? NO_LOAD : newLoad);
+        minHead.update(j, newHead);
+    }
+
+    // самый загруженный непустой процессор и процессор с самой короткой первой работой (-1, если работ нет)
+    int maxLoadCpu() const { return minHead.top() == NO_HEAD ? -1 : maxLoad.topIndex(); }
+    int minHeadCpu() const { return minHead.top() == NO_HEAD ? -1 : minHead.topIndex(); }
+
+    double k1() const {
+        if (minHead.top() == NO_HEAD) return 0.0; // нет ни одной работы
+        return double(maxLoad.top() - minHead.top());
+    }
+};
@@ -0,0 +1,395 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Отжиг цепочек в SIMD-линиях (малые экземпляры) ------------------------------
+// На малом экземпляре (N <= 64, M <= 16) одна цепочка не загружает ядро: ход стоит десятки тактов,
+// и почти все они — зависимые обращения к памяти. LockstepAnnealing ведёт LANES = 16 независимых
+// цепочек шаг в шаг, по цепочке в каждой 32-битной линии вектора AVX-512: за один шаг каждая цепочка
+// делает ход, и сборы, пересчёт K1 и приём выполняются сразу для всех шестнадцати.
+//
+// Представление. Порядок работ на процессоре влияет на K1 только через первую работу, и первой
+// выгоднее всего ставить самую длинную. Поэтому цепочка хранит только назначение работ процессорам,
+// а первой работой процессора считается его самая длинная. Работы перенумерованы по убыванию
+// длительности, так что самая длинная — младший бит 64-битной маски работ процессора.
+// Состояние — структура массивов по цепочкам: элемент (строка r, цепочка c) лежит в [r * LANES + c].
+//   cpuOf[job] — процессор работы;   load[p] — загрузка процессора;
+//   jobs[p]    — маска его работ;    head[p] — длительность самой длинной работы (NO_HEAD, если пусто).
+//
+// Ход: случайная работа j уходит на случайный другой процессор или, с вероятностью 1/2, меняется
+// местами со случайной работой k другого процессора. K1 после хода — один проход по M процессорам
+// с подстановкой двух изменённых. Правило приёма — как в SimulatedAnnealing: эталон обновляется только
+// при улучшении, noImprove сбрасывает любой принятый ход. Metropolis записан как delta < -T ln u,
+// u квантуется до 12 бит, и -ln u берётся из таблицы на 4096 значений. У каждой цепочки свой генератор:
+// последовательность Вейля с хеш-перемешиванием. Векторный и скалярный варианты дают одни и те же числа.
+// Температура и счётчик итераций общие. Цепочка выключается, когда остановилась бы сама
+// (noImproveLimit, нижняя граница K1), отжиг идёт, пока жива хоть одна и не исчерпан maxIter.
+// Результат — лучшее решение лучшей цепочки.
+//
+// Шаг есть в двух вариантах: скалярном (эталон и запасной путь) и AVX-512 (F + CD — vplzcntq ищет
+// младший бит маски). Вариант выбирается один раз по возможностям процессора; результат от него не зависит.
+// Варианта AVX2 нет: на процессоре без AVX-512 (в том числе с одним AVX2) шаг идёт скалярно.
+// Ходы — только перенос и обмен (как у --mutations=uniform); другие наборы мутаций здесь не поддерживаются.
+
+struct LockstepState {
+    static constexpr int LANES = 16;
+    static constexpr int NO_HEAD = numeric_limits<int>::max();
+    static constexpr int U_BITS = 12;
+
+    int N = 0, M = 0;
+    AlignedInts w;                                // длительности в новой нумерации (по убыванию)
+    AlignedInts cpuOf, load, head;                // строки по LANES цепочек
+    vector<uint64_t, AlignedAllocator<uint64_t>> jobs;
+    AlignedInts ref, noImprove;                   // по цепочке: эталон K1 (он же лучший K1) и счётчик
+    vector<uint32_t, AlignedAllocator<uint32_t>> rngState;
+    vector<float, AlignedAllocator<float>> negLogU; // -ln u для u = (i + 1/2) / 4096
+    uint32_t active = 0;                          // маска ещё идущих цепочек
+
+    LockstepState() : negLogU(1 << U_BITS) {
+        for (int i = 0; i < (1 << U_BITS); ++i) negLogU[i] = float(-log((i + 0.5) / (1 << U_BITS)));
+    }
+
+    static uint32_t mix(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    uint32_t nextRandom(int c) { return mix(rngState[c] += 0x9e3779b9u); }
+};
+
+namespace simd {
+
+// Один шаг всех цепочек; возвращает маску цепочек, улучшивших эталон. Скалярный эталон
+inline uint32_t lockstepStepScalar(LockstepState &s, float T, int noImproveLimit, int lowerBound) {
+    constexpr int L = LockstepState::LANES;
+    constexpr int NO_HEAD = LockstepState::NO_HEAD;
+    uint32_t improved = 0;
+    for (int c = 0; c < L; ++c) {
+        uint32_t r1 = s.nextRandom(c), r2 = s.nextRandom(c);
+        if (!(s.active >> c & 1)) continue;
+
+        int j = int(((r1 & 0xFFFF) * uint32_t(s.N)) >> 16);
+        int k = int(((r1 >> 16) * uint32_t(s.N)) >> 16);
+        bool swap = r2 & 1;
+        int dr = int((((r2 >> 1) & 0x7FFF) * uint32_t(s.M - 1)) >> 15);
+        int u = int(r2 >> (32 - LockstepState::U_BITS));
+
+        int src = s.cpuOf[j * L + c];
+        int d = swap ? s.cpuOf[k * L + c] : dr + (dr >= src);
+        bool valid = d != src;
+
+        int moved = s.w[j] - (swap ? s.w[k] : 0);
+        int loadS = s.load[src * L + c] - moved, loadD = s.load[d * L + c] + moved;
+        uint64_t bj = 1ULL << j, bk = swap ? 1ULL << k : 0;
+        uint64_t jobsS = (s.jobs[src * L + c] & ~bj) | bk;
+        uint64_t jobsD = (s.jobs[d * L + c] | bj) & ~bk;
+        int headS = jobsS ? s.w[__builtin_ctzll(jobsS)] : NO_HEAD;
+        int headD = jobsD ? s.w[__builtin_ctzll(jobsD)] : NO_HEAD;
+
+        int mx = numeric_limits<int>::min(), mn = NO_HEAD;
+        for (int p = 0; p < s.M; ++p) {
+            int l = p == src ? loadS : p == d ? loadD : s.load[p * L + c];
+            int h = p == src ? headS : p == d ? headD : s.head[p * L + c];
+            if (h != NO_HEAD) mx = max(mx, l);
+            mn = min(mn, h);
+        }
+        int k1 = mx - mn;
+        int delta = k1 - s.ref[c];
+        bool accept = valid && (delta <= 0 || float(delta) < T * s.negLogU[u]);
+
+        if (accept) {
+            s.cpuOf[j * L + c] = d;
+            if (swap) s.cpuOf[k * L + c] = src;
+            s.load[src * L + c] = loadS;
+            s.load[d * L + c] = loadD;
+            s.jobs[src * L + c] = jobsS;
+            s.jobs[d * L + c] = jobsD;
+            s.head[src * L + c] = headS;
+            s.head[d * L + c] = headD;
+        }
+        if (valid && delta < 0) {
+            s.ref[c] = k1;
+            improved |= 1u << c;
+        }
+        s.noImprove[c] = accept ? 0 : s.noImprove[c] + 1;
+        if (s.noImprove[c] >= noImproveLimit || s.ref[c] <= lowerBound) s.active &= ~(1u << c);
+    }
+    return improved;
+}
+
+#ifdef SA_X86_SIMD
+// GCC 12 при встраивании интринсиков AVX-512 в функции с target(...) ложно считает неинициализированным
+// _mm512_undefined_* внутри заголовков (ошибка GCC 105593) — по предупреждению на каждый сдвиг и сбор
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// индекс младшего бита 64-битных линий (-1 для нуля): 63 - lzcnt(x & -x)
+__attribute__((target("avx512f,avx512cd")))
+inline __m512i lowestBit64(__m512i x) {
+    __m512i low = _mm512_and_si512(x, _mm512_sub_epi64(_mm512_setzero_si512(), x));
+    return _mm512_sub_epi64(_mm512_set1_epi64(63), _mm512_lzcnt_epi64(low));
+}
+
+// адрес элемента (строка row, цепочка = линия) в массиве состояния
+__attribute__((target("avx512f")))
+inline __m512i laneAt(__m512i row) {
+    const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm512_add_epi32(_mm512_slli_epi32(row, 4), lane);
+}
+
+// половина h (цепочки 8h .. 8h + 7) 32-битного вектора — индексы для 64-битных сборов
+__attribute__((target("avx512f")))
+inline __m256i laneHalf(__m512i v, int h) {
+    return h ? _mm512_extracti64x4_epi64(v, 1) : _mm512_castsi512_si256(v);
+}
+
+// следующее число генератора каждой линии — та же формула, что LockstepState::mix
+__attribute__((target("avx512f")))
+inline __m512i nextRandomLanes(__m512i &state) {
+    state = _mm512_add_epi32(state, _mm512_set1_epi32(int(0x9e3779b9u)));
+    __m512i x = _mm512_xor_si512(state, _mm512_srli_epi32(state, 16));
+    x = _mm512_mullo_epi32(x, _mm512_set1_epi32(0x7feb352d));
+    x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 15));
+    x = _mm512_mullo_epi32(x, _mm512_set1_epi32(int(0x846ca68bu)));
+    return _mm512_xor_si512(x, _mm512_srli_epi32(x, 16));
+}
+
+__attribute__((target("avx512f,avx512cd")))
+inline uint32_t lockstepStepAvx512(LockstepState &s, float T, int noImproveLimit, int lowerBound) {
+    constexpr int NO_HEAD = LockstepState::NO_HEAD;
+    const __m512i one = _mm512_set1_epi32(1), zero = _mm512_setzero_si512();
+    const __m512i noHead = _mm512_set1_epi32(NO_HEAD);
+    const __m512i one64 = _mm512_set1_epi64(1);
+
+    __m512i state = _mm512_load_si512(s.rngState.data());
+    __m512i r1 = nextRandomLanes(state), r2 = nextRandomLanes(state);
+    _mm512_store_si512(s.rngState.data(), state);
+
+    __mmask16 active = __mmask16(s.active);
+    __m512i j = _mm512_srli_epi32(_mm512_mullo_epi32(_mm512_and_si512(r1, _mm512_set1_epi32(0xFFFF)),
+                                                     _mm512_set1_epi32(s.N)), 16);
+    __m512i k = _mm512_srli_epi32(_mm512_mullo_epi32(_mm512_srli_epi32(r1, 16), _mm512_set1_epi32(s.N)), 16);
+    __mmask16 swap = _mm512_test_epi32_mask(r2, one);
+    __m512i dr = _mm512_srli_epi32(_mm512_mullo_epi32(_mm512_and_si512(_mm512_srli_epi32(r2, 1), _mm512_set1_epi32(0x7FFF)),
+                                                      _mm512_set1_epi32(s.M - 1)), 15);
+    __m512i u = _mm512_srli_epi32(r2, 32 - LockstepState::U_BITS);
+
+    __m512i src = _mm512_i32gather_epi32(laneAt(j), s.cpuOf.data(), 4);
+    __m512i d = _mm512_mask_add_epi32(dr, _mm512_cmpge_epi32_mask(dr, src), dr, one);
+    d = _mm512_mask_i32gather_epi32(d, swap, laneAt(k), s.cpuOf.data(), 4);
+    __mmask16 valid = active & _mm512_cmpneq_epi32_mask(d, src);
+
+    __m512i wk = _mm512_mask_i32gather_epi32(zero, swap, k, s.w.data(), 4);
+    __m512i moved = _mm512_sub_epi32(_mm512_i32gather_epi32(j, s.w.data(), 4), wk);
+    __m512i atS = laneAt(src), atD = laneAt(d);
+    __m512i loadS = _mm512_sub_epi32(_mm512_i32gather_epi32(atS, s.load.data(), 4), moved);
+    __m512i loadD = _mm512_add_epi32(_mm512_i32gather_epi32(atD, s.load.data(), 4), moved);
+
+    // маски работ — 64-битные, по половине цепочек за раз
+    __m512i jobsS[2], jobsD[2];
+    __m256i firstS[2], firstD[2];
+    for (int h = 0; h < 2; ++h) {
+        __m256i jh = laneHalf(j, h), kh = laneHalf(k, h);
+        __mmask8 swapH = __mmask8(swap >> (8 * h));
+        __m512i bj = _mm512_sllv_epi64(one64, _mm512_cvtepu32_epi64(jh));
+        __m512i bk = _mm512_maskz_sllv_epi64(swapH, one64, _mm512_cvtepu32_epi64(kh));
+        __m512i mS = _mm512_i32gather_epi64(laneHalf(atS, h), s.jobs.data(), 8);
+        __m512i mD = _mm512_i32gather_epi64(laneHalf(atD, h), s.jobs.data(), 8);
+        jobsS[h] = _mm512_or_si512(_mm512_andnot_si512(bj, mS), bk);
+        jobsD[h] = _mm512_andnot_si512(bk, _mm512_or_si512(mD, bj));
+        firstS[h] = _mm512_cvtepi64_epi32(lowestBit64(jobsS[h]));
+        firstD[h] = _mm512_cvtepi64_epi32(lowestBit64(jobsD[h]));
+    }
+    __m512i fS = _mm512_inserti64x4(_mm512_castsi256_si512(firstS[0]), firstS[1], 1);
+    __m512i fD = _mm512_inserti64x4(_mm512_castsi256_si512(firstD[0]), firstD[1], 1);
+    __m512i headS = _mm512_mask_i32gather_epi32(noHead, _mm512_cmpge_epi32_mask(fS, zero), fS, s.w.data(), 4);
+    __m512i headD = _mm512_mask_i32gather_epi32(noHead, _mm512_cmpge_epi32_mask(fD, zero), fD, s.w.data(), 4);
+
+    __m512i mx = _mm512_set1_epi32(numeric_limits<int>::min()), mn = noHead;
+    for (int p = 0; p < s.M; ++p) {
+        __m512i pv = _mm512_set1_epi32(p);
+        __mmask16 isS = _mm512_cmpeq_epi32_mask(src, pv), isD = _mm512_cmpeq_epi32_mask(d, pv);
+        __m512i l = _mm512_load_si512(s.load.data() + p * LockstepState::LANES);
+        __m512i hd = _mm512_load_si512(s.head.data() + p * LockstepState::LANES);
+        // источник подставляется последним — как в скалярном варианте
+        l = _mm512_mask_mov_epi32(_mm512_mask_mov_epi32(l, isD, loadD), isS, loadS);
+        hd = _mm512_mask_mov_epi32(_mm512_mask_mov_epi32(hd, isD, headD), isS, headS);
+        mx = _mm512_mask_max_epi32(mx, _mm512_cmpneq_epi32_mask(hd, noHead), mx, l);
+        mn = _mm512_min_epi32(mn, hd);
+    }
+    __m512i k1 = _mm512_sub_epi32(mx, mn);
+    __m512i ref = _mm512_load_si512(s.ref.data());
+    __m512i delta = _mm512_sub_epi32(k1, ref);
+    __m512 threshold = _mm512_mul_ps(_mm512_set1_ps(T), _mm512_i32gather_ps(u, s.negLogU.data(), 4));
+    __mmask16 accept = valid & (_mm512_cmple_epi32_mask(delta, zero) |
+                                _mm512_cmp_ps_mask(_mm512_cvtepi32_ps(delta), threshold, _CMP_LT_OQ));
+
+    _mm512_mask_i32scatter_epi32(s.cpuOf.data(), accept, laneAt(j), d, 4);
+    _mm512_mask_i32scatter_epi32(s.cpuOf.data(), accept & swap, laneAt(k), src, 4);
+    _mm512_mask_i32scatter_epi32(s.load.data(), accept, atS, loadS, 4);
+    _mm512_mask_i32scatter_epi32(s.load.data(), accept, atD, loadD, 4);
+    _mm512_mask_i32scatter_epi32(s.head.data(), accept, atS, headS, 4);
+    _mm512_mask_i32scatter_epi32(s.head.data(), accept, atD, headD, 4);
+    for (int h = 0; h < 2; ++h) {
+        __mmask8 acceptH = __mmask8(accept >> (8 * h));
+        _mm512_mask_i32scatter_epi64(s.jobs.data(), acceptH, laneHalf(atS, h), jobsS[h], 8);
+        _mm512_mask_i32scatter_epi64(s.jobs.data(), acceptH, laneHalf(atD, h), jobsD[h], 8);
+    }
+
+    __mmask16 improved = valid & _mm512_cmplt_epi32_mask(delta, zero);
+    ref = _mm512_mask_mov_epi32(ref, improved, k1);
+    _mm512_store_si512(s.ref.data(), ref);
+    __m512i noImprove = _mm512_load_si512(s.noImprove.data());
+    noImprove = _mm512_mask_mov_epi32(noImprove, active, _mm512_maskz_add_epi32(~accept, noImprove, one));
+    _mm512_store_si512(s.noImprove.data(), noImprove);
+
+    active &= _mm512_cmplt_epi32_mask(noImprove, _mm512_set1_epi32(noImproveLimit)) &
+              _mm512_cmpgt_epi32_mask(ref, _mm512_set1_epi32(lowerBound));
+    s.active = active;
+    return improved;
+}
+
+#pragma GCC diagnostic pop
+#endif
+
+using LockstepStep = uint32_t (*)(LockstepState &, float, int, int);
+
+// шаг для текущего процессора (определяется один раз)
+inline LockstepStep lockstepStep(const char **name = nullptr) {
+    static const pair<LockstepStep, const char *> chosen = [] {
+#ifdef SA_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd"))
+            return make_pair(LockstepStep(lockstepStepAvx512), "avx512");
+#endif
+        return make_pair(LockstepStep(lockstepStepScalar), "scalar");
+    }();
+    if (name) *name = chosen.second;
+    return chosen.first;
+}
+
+} // namespace simd
+
+struct LockstepAnnealing {
+    static constexpr int LANES = LockstepState::LANES;
+
+    double T0;
+    int maxIterations;
+    int noImproveLimit;
+    double lowerBound = 0;   // K1 меньше не бывает: цепочка, дошедшая до неё, останавливается
+    uint64_t seed;
+    simd::LockstepStep step = simd::lockstepStep(); // можно заменить на simd::lockstepStepScalar
+    TemperatureTable temperatures;
+    SA_TM(shared_ptr<EngineTelemetry> tm = telemetry().add();)
+
+    // экземпляр помещается в линии: маска работ — 64 бита, процессоров не больше 16 (и хотя бы два для хода)
+    static bool fits(int N, int M) { return N >= 1 && N <= 64 && M >= 2 && M <= 16; }
+
+    LockstepAnnealing(double T0_, int maxIter_, int noImproveLimit_, uint64_t seed_)
+        : T0(T0_), maxIterations(maxIter_), noImproveLimit(noImproveLimit_), seed(seed_), temperatures(T0_) {}
+
+    // Отжиг LANES цепочек из решения initial (любой раскладки, fits(N, M)); результат — списки работ
+    // лучшей цепочки, на каждом процессоре первой стоит самая длинная работа
+    template <class Cool>
+    vector<vector<int>> run(const Solution &initial, Cool cooling) {
+        constexpr int L = LANES;
+        LockstepState s;
+        vector<int> order; // order[r] — исходный номер r-й по длительности работы
+        vector<int> initialCpu;
+        withSchedule(initial, [&](const auto &sch) {
+            s.N = sch.N;
+            s.M = sch.M;
+            order.resize(sch.N);
+            iota(order.begin(), order.end(), 0);
+            stable_sort(order.begin(), order.end(), [&](int a, int b) { return sch.w[a] > sch.w[b]; });
+            initialCpu.assign(sch.N, 0);
+            for (int p = 0; p < sch.M; ++p)
+                for (int i = 0; i < sch.cpuSize(p); ++i) initialCpu[sch.job(p, i)] = p;
+            s.w.resize(sch.N);
+            for (int r = 0; r < sch.N; ++r) s.w[r] = sch.w[order[r]];
+        });
+        int N = s.N, M = s.M;
+
+        // все цепочки стартуют с одного решения; различаются генераторами
+        s.cpuOf.assign(N * L, 0);
+        s.load.assign(M * L, 0);
+        s.head.assign(M * L, LockstepState::NO_HEAD);
+        s.jobs.assign(M * L, 0);
+        for (int r = N - 1; r >= 0; --r) {
+            int p = initialCpu[order[r]];
+            for (int c = 0; c < L; ++c) {
+                s.cpuOf[r * L + c] = p;
+                s.load[p * L + c] += s.w[r];
+                s.jobs[p * L + c] |= 1ULL << r;
+                s.head[p * L + c] = s.w[r]; // последней записывается самая длинная
+            }
+        }
+        int Tmax = numeric_limits<int>::min(), Tmin = LockstepState::NO_HEAD;
+        for (int p = 0; p < M; ++p) {
+            if (s.head[p * L] == LockstepState::NO_HEAD) continue;
+            Tmax = max(Tmax, s.load[p * L]);
+            Tmin = min(Tmin, s.head[p * L]);
+        }
+        s.ref.assign(L, Tmax - Tmin);
+        s.noImprove.assign(L, 0);
+        s.rngState.resize(L);
+        for (int c = 0; c < L; ++c) s.rngState[c] = engineSeed(splitSeed(seed, c));
+        int bound = int(floor(lowerBound));
+        s.active = Tmax - Tmin > bound ? (1u << L) - 1 : 0;
+
+        // лучшее решение цепочки c — строка best[c * N ..]; эталон цепочки и есть её лучший K1
+        vector<int> best(L * N);
+        for (int c = 0; c < L; ++c)
+            for (int r = 0; r < N; ++r) best[c * N + r] = s.cpuOf[r * L + c];
+
+        double T = T0;
+        SA_TM(TmStopwatch sw;)
+        for (int iter = 0; s.active && iter < maxIterations;) {
+            SA_TM(int running = __builtin_popcount(s.active);)
+            uint32_t improved = step(s, float(T), noImproveLimit, bound);
+            for (uint32_t m = improved; m; m &= m - 1) {
+                int c = __builtin_ctz(m);
+                for (int r = 0; r < N; ++r) best[c * N + r] = s.cpuOf[r * L + c];
+            }
+            ++iter;
+            T = temperatures.next(cooling, T, iter);
+            SA_TM(tm->improving += __builtin_popcount(improved); tm->tick(T, LaneBest{s}, running);)
+        }
+        SA_TM(tm->annealSeconds += sw.lap();)
+
+        int b = int(min_element(s.ref.begin(), s.ref.end()) - s.ref.begin());
+        vector<vector<int>> lists(M);
+        for (int r = 0; r < N; ++r) lists[best[b * N + r]].push_back(order[r]);
+        return lists;
+    }
+
+private:
+    // лучший K1 по цепочкам — для трассы телеметрии
+    struct LaneBest {
+        const LockstepState &s;
+        double criteria() const { return *min_element(s.ref.begin(), s.ref.end()); }
+    };
+};
+
+// Отжиг малого экземпляра цепочками в SIMD-линиях; не помещающийся в линии (LockstepAnnealing::fits)
+// решается static-движком — только для него и действует mutations. Раскладка результата — как у initial
+unique_ptr<Solution> runLockstepAnnealing(const Solution &initial, const string &coolingType, double T0,
+                                          int maxIter, int noImproveLimit, uint32_t seed = 0,
+                                          double lowerBound = 0, const string &mutations = "uniform") {
+    return withSchedule(initial, [&](const auto &sch) -> unique_ptr<Solution> {
+        if (!LockstepAnnealing::fits(sch.N, sch.M))
+            return runStaticAnnealing(initial, coolingType, T0, maxIter, noImproveLimit, seed, lowerBound, mutations);
+        if (seed == 0) seed = random_device()();
+        LockstepAnnealing la(T0, maxIter, noImproveLimit, seed);
+        la.lowerBound = lowerBound;
+        vector<vector<int>> lists = withCooling(coolingType, T0, [&](auto cooling) { return la.run(sch, cooling); });
+        ScheduleSolution best(sch.N, sch.M, sch.w, move(lists));
+        if (is_same_v<decay_t<decltype(sch)>, FlatScheduleSolution>) return make_unique<FlatScheduleSolution>(best);
+        return make_unique<ScheduleSolution>(move(best));
+    });
+}
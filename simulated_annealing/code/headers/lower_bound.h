@@ -0,0 +1,40 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Нижняя граница K1 ------------------------------
+// K1 = Tmax - Tmin: Tmax — наибольшая загрузка, Tmin — наименьшая первая работа среди занятых процессоров.
+// Пусть занято k процессоров. Тогда Tmax >= max(ceil(S / k), wmax), где S — сумма длительностей,
+// а первые работы — k разных работ, так что Tmin не больше k-й по величине длительности w(k).
+// Отсюда K1 >= min по k = 1..min(N, M) от max(ceil(S / k), wmax) - w(k); кроме того, K1 >= 0
+// (Tmax не меньше первой работы своего процессора, а та не меньше Tmin).
+// Граница считается один раз на экземпляр за O(N log M). Отжиг, дошедший до неё, нашёл оптимум и
+// останавливается; иначе в итог печатается оставшийся разрыв.
+double k1LowerBound(const JobDurations &w, int M) {
+    int K = min((int)w.size(), M);
+    if (K <= 0) return 0;
+
+    vector<int> top(w.begin(), w.end());
+    partial_sort(top.begin(), top.begin() + K, top.end(), greater<int>());
+    long long S = accumulate(w.begin(), w.end(), 0LL);
+
+    long long bound = numeric_limits<long long>::max();
+    for (int k = 1; k <= K; ++k) {
+        long long Tmax = max<long long>((S + k - 1) / k, top[0]);
+        bound = min(bound, Tmax - top[k - 1]);
+    }
+    return double(max(bound, 0LL));
+}
+
+// Строка итога: граница и разрыв до неё (в процентах от найденного K1). K1 целый — печатается без экспоненты
+string gapReport(double k1, double bound) {
+    ostringstream oss;
+    oss << "Нижняя граница K1 = " << (long long)bound;
+    if (k1 <= bound) {
+        oss << ": решение оптимально";
+    } else {
+        oss << ", разрыв " << (long long)(k1 - bound) << " (" << fixed << setprecision(3)
+            << 100.0 * (k1 - bound) / k1 << "%)";
+    }
+    return oss.str();
+}
@@ -2,51 +2,284 @@ using namespace std;
 
 // ------------------------------ Конкретные мутации ------------------------------
 
+// Вызывает f с конкретной раскладкой расписания (ScheduleSolution или FlatScheduleSolution).
+// Обе раскладки дают M, cpuSize(p), swapJobs и moveJob, поэтому мутации пишутся один раз шаблоном.
+template <class F>
+decltype(auto) withSchedule(Solution &s, F &&f) {
+    if (auto *sch = dynamic_cast<ScheduleSolution*>(&s)) return f(*sch);
+    if (auto *flat = dynamic_cast<FlatScheduleSolution*>(&s)) return f(*flat);
+    throw bad_cast();
+}
+
+template <class F>
+decltype(auto) withSchedule(const Solution &s, F &&f) {
+    if (auto *sch = dynamic_cast<const ScheduleSolution*>(&s)) return f(*sch);
+    if (auto *flat = dynamic_cast<const FlatScheduleSolution*>(&s)) return f(*flat);
+    throw bad_cast();
+}
+
 // 1) SwapTwoJobs: выбирает случайно две работы (возможно на одном и том же CPU) и меняет их местами.
-struct SwapTwoJobs : Mutation {
-    void apply(Solution &s, mt19937 &rng) const override {
-        auto *sch = dynamic_cast<ScheduleSolution*>(&s);
-        if (!sch) throw bad_cast();
-        uniform_int_distribution<int> cpuDist(0, max(0, sch->M - 1));
+// Нейтральны (K1 не меняют): обмен внутри процессора без позиции 0 и обмен работ равной длительности.
+struct SwapTwoJobs final : Mutation {
+    string name() const override { return "SwapTwoJobs"; }
+
+    MoveRecord apply(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyTo(sch, rng); });
+    }
+
+    MoveRecord applyFiltered(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyFilteredTo(sch, rng); });
+    }
+
+    void undo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { undoOn(sch, rec); });
+    }
+
+    void redo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { redoOn(sch, rec); });
+    }
+
+    // swap обратим сам себе: откат — тот же обмен позиций (p1, i1) и (p2, i2)
+    template <class S>
+    void undoOn(S &sch, const MoveRecord &rec) const {
+        if (rec.by) sch.swapJobs(rec.p1, rec.i1, rec.p2, rec.i2);
+    }
+
+    template <class S>
+    void redoOn(S &sch, const MoveRecord &rec) const {
+        if (rec.by) sch.swapJobs(rec.p1, rec.i1, rec.p2, rec.i2);
+    }
+
+    template <class S>
+    MoveRecord applyTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        redoOn(sch, rec);
+        return rec;
+    }
+
+    template <class S>
+    MoveRecord applyFilteredTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        if (!rec.neutral) redoOn(sch, rec);
+        return rec;
+    }
+
+    // выбрать ход, не применяя его; neutral — за O(1), по правилу в заголовке структуры
+    template <class S>
+    MoveRecord proposeOn(const S &sch, mt19937 &rng) const {
+        uniform_int_distribution<int> cpuDist(0, max(0, sch.M - 1));
         // выбираем два CPU (возможно равные)
         int p1 = cpuDist(rng);
         int p2 = cpuDist(rng);
-        if (sch->jobLists[p1].empty()) {
-            // если пустой, попробуем найти непустой
-            for (int i = 0; i < sch->M; ++i) if (!sch->jobLists[i].empty()) { p1 = i; break; }
-        }
-        if (sch->jobLists[p2].empty()) {
-            for (int i = 0; i < sch->M; ++i) if (!sch->jobLists[i].empty()) { p2 = i; break; }
-        }
-        if (sch->jobLists[p1].empty() || sch->jobLists[p2].empty()) return; // некуда swap'ить
-        uniform_int_distribution<int> idx1(0, sch->jobLists[p1].size() - 1);
-        uniform_int_distribution<int> idx2(0, sch->jobLists[p2].size() - 1);
+        const vector<int> &nonEmpty = sch.index.nonEmpty;
+        if (nonEmpty.empty()) return {}; // некуда swap'ить
+        // если пустой, берём первый непустой
+        if (sch.cpuSize(p1) == 0) p1 = nonEmpty.front();
+        if (sch.cpuSize(p2) == 0) p2 = nonEmpty.front();
+        uniform_int_distribution<int> idx1(0, sch.cpuSize(p1) - 1);
+        uniform_int_distribution<int> idx2(0, sch.cpuSize(p2) - 1);
         int i1 = idx1(rng);
         int i2 = idx2(rng);
-        sch->swapJobs(p1, i1, p2, i2);
+        MoveRecord rec{this, p1, i1, p2, i2};
+        rec.neutral = (p1 == p2 && (i1 == i2 || (i1 != 0 && i2 != 0)))
+                      || sch.w[sch.job(p1, i1)] == sch.w[sch.job(p2, i2)];
+        return rec;
     }
 };
 
 // 2) MoveJob: взять случайную работу и переместить её в случайную позицию на другом процессоре (или в другой позиции того же).
-struct MoveJob : Mutation {
-    void apply(Solution &s, mt19937 &rng) const override {
-        auto *sch = dynamic_cast<ScheduleSolution*>(&s);
-        if (!sch) throw bad_cast();
-        // найти непустой процессор-источник
-        vector<int> nonEmpty;
-        for (int j = 0; j < sch->M; ++j) if (!sch->jobLists[j].empty()) nonEmpty.push_back(j);
-        if (nonEmpty.empty()) return;
+// Нейтральна перестановка внутри процессора, не задевающая позицию 0.
+struct MoveJob final : Mutation {
+    string name() const override { return "MoveJob"; }
+
+    MoveRecord apply(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyTo(sch, rng); });
+    }
+
+    MoveRecord applyFiltered(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyFilteredTo(sch, rng); });
+    }
+
+    void undo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { undoOn(sch, rec); });
+    }
+
+    void redo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { redoOn(sch, rec); });
+    }
+
+    // работа сейчас стоит в (p2, i2) — возвращаем её в (p1, i1)
+    template <class S>
+    void undoOn(S &sch, const MoveRecord &rec) const {
+        if (rec.by) sch.moveJob(rec.p2, rec.i2, rec.p1, rec.i1);
+    }
+
+    template <class S>
+    void redoOn(S &sch, const MoveRecord &rec) const {
+        if (rec.by) sch.moveJob(rec.p1, rec.i1, rec.p2, rec.i2);
+    }
+
+    template <class S>
+    MoveRecord applyTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        redoOn(sch, rec);
+        return rec;
+    }
+
+    template <class S>
+    MoveRecord applyFilteredTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        if (!rec.neutral) redoOn(sch, rec);
+        return rec;
+    }
+
+    // выбрать ход, не применяя его; neutral — за O(1), по правилу в заголовке структуры
+    template <class S>
+    MoveRecord proposeOn(const S &sch, mt19937 &rng) const {
+        // непустой процессор-источник — из списка, который поддерживает индекс K1 решения
+        const vector<int> &nonEmpty = sch.index.nonEmpty;
+        if (nonEmpty.empty()) return {};
         uniform_int_distribution<int> pickSrc(0, nonEmpty.size() - 1);
         int p_from = nonEmpty[pickSrc(rng)];
-        uniform_int_distribution<int> idxFrom(0, sch->jobLists[p_from].size() - 1);
+        uniform_int_distribution<int> idxFrom(0, sch.cpuSize(p_from) - 1);
+        int idx_in_from = idxFrom(rng);
+
+        uniform_int_distribution<int> pickCpu(0, sch.M - 1);
+        int p_to = pickCpu(rng);
+        uniform_int_distribution<int> pos(0, max(0, sch.cpuSize(p_to)));
+        int position = pos(rng);
+        // внутри одного процессора после удаления позиций на одну меньше — moveJob прижмёт к концу
+        if (p_to == p_from) position = min(position, sch.cpuSize(p_to) - 1);
+
+        MoveRecord rec{this, p_from, idx_in_from, p_to, position};
+        rec.neutral = p_to == p_from && (idx_in_from == position || (idx_in_from != 0 && position != 0));
+        return rec;
+    }
+};
+
+// ------ Направленные мутации ------
+// K1 = Tmax - Tmin определяют два процессора: самый загруженный и тот, чья первая работа короче всех.
+// Равномерные ходы при большом M почти всегда их не задевают; направленные берут их из индекса K1
+// решения за O(1) и ничего не выделяют. Откат и нейтральность — как у SwapTwoJobs и MoveJob.
+
+// 3) MoveFromCritical: случайная работа самого загруженного процессора уходит в случайную позицию
+// другого процессора (снижает Tmax). Ход всегда между процессорами — нейтральным не бывает.
+struct MoveFromCritical final : Mutation {
+    string name() const override { return "MoveFromCritical"; }
+
+    MoveJob move;
+
+    MoveRecord apply(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyTo(sch, rng); });
+    }
+
+    MoveRecord applyFiltered(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyFilteredTo(sch, rng); });
+    }
+
+    void undo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { undoOn(sch, rec); });
+    }
+
+    void redo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { redoOn(sch, rec); });
+    }
+
+    template <class S>
+    void undoOn(S &sch, const MoveRecord &rec) const { move.undoOn(sch, rec); }
+
+    template <class S>
+    void redoOn(S &sch, const MoveRecord &rec) const { move.redoOn(sch, rec); }
+
+    template <class S>
+    MoveRecord applyTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        redoOn(sch, rec);
+        return rec;
+    }
+
+    template <class S>
+    MoveRecord applyFilteredTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        if (!rec.neutral) redoOn(sch, rec);
+        return rec;
+    }
+
+    template <class S>
+    MoveRecord proposeOn(const S &sch, mt19937 &rng) const {
+        int p_from = sch.index.maxLoadCpu();
+        if (p_from < 0 || sch.M < 2) return {};
+        uniform_int_distribution<int> idxFrom(0, sch.cpuSize(p_from) - 1);
         int idx_in_from = idxFrom(rng);
 
-        uniform_int_distribution<int> pickCpu(0, sch->M - 1);
+        // любой процессор, кроме источника
+        uniform_int_distribution<int> pickCpu(0, sch.M - 2);
         int p_to = pickCpu(rng);
-        uniform_int_distribution<int> pos(0, max(0, (int)sch->jobLists[p_to].size()));
+        if (p_to >= p_from) ++p_to;
+        uniform_int_distribution<int> pos(0, sch.cpuSize(p_to));
         int position = pos(rng);
 
-        sch->moveJob(p_from, idx_in_from, p_to, position);
+        // ход и откат выполняет MoveJob: запись та же
+        return {this, p_from, idx_in_from, p_to, position};
+    }
+};
+
+// 4) SwapMinHead: первая работа процессора с самой короткой первой работой меняется со случайной
+// работой (поднимает Tmin). Нейтрален только обмен работ равной длительности.
+struct SwapMinHead final : Mutation {
+    string name() const override { return "SwapMinHead"; }
+
+    SwapTwoJobs swap;
+
+    MoveRecord apply(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyTo(sch, rng); });
+    }
+
+    MoveRecord applyFiltered(Solution &s, mt19937 &rng) const override {
+        return withSchedule(s, [&](auto &sch) { return applyFilteredTo(sch, rng); });
+    }
+
+    void undo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { undoOn(sch, rec); });
+    }
+
+    void redo(Solution &s, const MoveRecord &rec) const override {
+        withSchedule(s, [&](auto &sch) { redoOn(sch, rec); });
+    }
+
+    template <class S>
+    void undoOn(S &sch, const MoveRecord &rec) const { swap.undoOn(sch, rec); }
+
+    template <class S>
+    void redoOn(S &sch, const MoveRecord &rec) const { swap.redoOn(sch, rec); }
+
+    template <class S>
+    MoveRecord applyTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        redoOn(sch, rec);
+        return rec;
+    }
+
+    template <class S>
+    MoveRecord applyFilteredTo(S &sch, mt19937 &rng) const {
+        MoveRecord rec = proposeOn(sch, rng);
+        if (!rec.neutral) redoOn(sch, rec);
+        return rec;
+    }
+
+    template <class S>
+    MoveRecord proposeOn(const S &sch, mt19937 &rng) const {
+        int p1 = sch.index.minHeadCpu();
+        if (p1 < 0) return {};
+        const vector<int> &nonEmpty = sch.index.nonEmpty;
+        uniform_int_distribution<int> pickSrc(0, (int)nonEmpty.size() - 1);
+        int p2 = nonEmpty[pickSrc(rng)];
+        uniform_int_distribution<int> idx2(0, sch.cpuSize(p2) - 1);
+        int i2 = idx2(rng);
+
+        MoveRecord rec{this, p1, 0, p2, i2};
+        rec.neutral = (p1 == p2 && i2 == 0) || sch.w[sch.job(p1, 0)] == sch.w[sch.job(p2, i2)];
+        return rec;
     }
 };
 
@@ -54,8 +287,61 @@ struct MoveJob : Mutation {
 struct CompositeMutation : Mutation {
     vector<shared_ptr<Mutation>> muts;
     CompositeMutation(const vector<shared_ptr<Mutation>>& v) : muts(v) {}
-    void apply(Solution &s, mt19937 &rng) const override {
+    MoveRecord apply(Solution &s, mt19937 &rng) const override {
+        uniform_int_distribution<int> dist(0, (int)muts.size()-1);
+        return muts[dist(rng)]->apply(s, rng);
+    }
+    MoveRecord applyFiltered(Solution &s, mt19937 &rng) const override {
         uniform_int_distribution<int> dist(0, (int)muts.size()-1);
-        muts[dist(rng)]->apply(s, rng);
+        return muts[dist(rng)]->applyFiltered(s, rng);
+    }
+    // запись хранит конкретную мутацию, которая была применена
+    void undo(Solution &s, const MoveRecord &rec) const override {
+        if (rec.by) rec.by->undo(s, rec);
+    }
+    void redo(Solution &s, const MoveRecord &rec) const override {
+        if (rec.by) rec.by->redo(s, rec);
     }
+    string name() const override { return "CompositeMutation"; }
 };
+
+// Смесь тех же мутаций с адаптивными долями (см. operator_bandit.h). Статистика бандита — состояние,
+// поэтому каждый движок работает со своей копией (forEngine), а сами мутации общие
+struct AdaptiveMutation final : CompositeMutation {
+    mutable OperatorBandit bandit;
+
+    AdaptiveMutation(const vector<shared_ptr<Mutation>> &v) : CompositeMutation(v), bandit(namesOf(v)) {}
+
+    MoveRecord apply(Solution &s, mt19937 &rng) const override {
+        return bandit.pull(rng, [&](int k) { return muts[k]->apply(s, rng); });
+    }
+    MoveRecord applyFiltered(Solution &s, mt19937 &rng) const override {
+        return bandit.pull(rng, [&](int k) { return muts[k]->applyFiltered(s, rng); });
+    }
+    void accepted(const MoveRecord &rec, double gain) const override {
+        for (size_t k = 0; k < muts.size(); ++k)
+            if (muts[k].get() == rec.by) bandit.credit(k, gain);
+    }
+    string name() const override { return "AdaptiveMutation"; }
+    shared_ptr<Mutation> forEngine(const shared_ptr<Mutation> &) const override {
+        return make_shared<AdaptiveMutation>(muts);
+    }
+
+    static vector<string> namesOf(const vector<shared_ptr<Mutation>> &v) {
+        vector<string> names;
+        for (const auto &m : v) names.push_back(m->name());
+        return names;
+    }
+};
+
+// Набор мутаций по имени (--mutations): uniform — SwapTwoJobs + MoveJob; guided — к ним добавляются
+// MoveFromCritical и SwapMinHead; adaptive — те же четыре с адаптивными долями. Неизвестное имя — uniform
+shared_ptr<Mutation> makeMutation(const string &kind) {
+    vector<shared_ptr<Mutation>> muts = {make_shared<SwapTwoJobs>(), make_shared<MoveJob>()};
+    if (kind == "guided" || kind == "adaptive") {
+        muts.push_back(make_shared<MoveFromCritical>());
+        muts.push_back(make_shared<SwapMinHead>());
+    }
+    if (kind == "adaptive") return make_shared<AdaptiveMutation>(muts);
+    return make_shared<CompositeMutation>(muts);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Адаптивный выбор мутаций ------------------------------
+// Какие ходы полезны, зависит от экземпляра (отношение N/M, разброс длительностей) и от стадии отжига,
+// поэтому смесь с равными долями тратит итерации впустую. OperatorBandit — многорукий бандит
+// с сопоставлением вероятностей (probability matching). Выгода оператора — уменьшение K1 его ходами,
+// которые движок принял (о них он сообщает через Mutation::accepted), на один вызов оператора,
+// с экспоненциальным забыванием (DECAY на каждый вызов). Цена вызова у всех операторов одна и та же:
+// от времени выбор не зависит, и при том же сиде прогон повторяется бит в бит.
+// Вероятность выбора пропорциональна выгоде, но не меньше 1/(4K): ни один из K операторов
+// не забрасывается, и выгода каждого продолжает оцениваться. Вероятности пересчитываются раз
+// в UPDATE_EVERY выборов. Время каждого TIME_EVERY-го вызова замеряется только для отчёта.
+// Счётчики всех бандитов запуска сводятся в operatorReport() — отчёт по операторам в конце прогона.
+
+struct OperatorStats {
+    string name;
+    long long uses = 0;        // вызовы
+    long long improving = 0;   // принятые ходы, уменьшившие K1
+    double gain = 0;           // суммарное уменьшение K1 ими
+    long long timedCalls = 0;  // замеренные вызовы и их время (только для отчёта)
+    double timedSeconds = 0;
+
+    double secondsPerCall() const { return timedCalls ? timedSeconds / timedCalls : 0.0; }
+};
+
+// Счётчики бандитов всех движков запуска; печать сводит их по имени оператора
+struct OperatorReport {
+    mutex m;
+    vector<shared_ptr<vector<OperatorStats>>> sets;
+
+    shared_ptr<vector<OperatorStats>> add(const vector<string> &names) {
+        auto s = make_shared<vector<OperatorStats>>(names.size());
+        for (size_t k = 0; k < names.size(); ++k) (*s)[k].name = names[k];
+        lock_guard<mutex> lock(m);
+        sets.push_back(s);
+        return s;
+    }
+
+    bool empty() {
+        lock_guard<mutex> lock(m);
+        return sets.empty();
+    }
+
+    // вызывать после того, как движки остановились: счётчики читаются без синхронизации с ними
+    void print(ostream &out) {
+        lock_guard<mutex> lock(m);
+        vector<OperatorStats> total;
+        for (const auto &s : sets)
+            for (const OperatorStats &op : *s) {
+                auto it = find_if(total.begin(), total.end(), [&](const OperatorStats &t) { return t.name == op.name; });
+                if (it == total.end()) {
+                    total.push_back(OperatorStats());
+                    it = prev(total.end());
+                    it->name = op.name;
+                }
+                it->uses += op.uses;
+                it->improving += op.improving;
+                it->gain += op.gain;
+                it->timedCalls += op.timedCalls;
+                it->timedSeconds += op.timedSeconds;
+            }
+        long long calls = 0;
+        for (const auto &t : total) calls += t.uses;
+
+        out << "Операторы мутаций (адаптивный выбор, движков: " << sets.size() << "):\n";
+        for (const auto &t : total) {
+            out << "  " << left << setw(18) << t.name << right
+                << " вызовов " << setw(10) << t.uses
+                << " (" << fixed << setprecision(1) << setw(5) << (calls ? 100.0 * t.uses / calls : 0.0) << "%)"
+                << ", улучшений " << setw(8) << t.improving
+                << ", выигрыш K1 " << setw(10) << (long long)t.gain
+                << ", " << setprecision(0) << setw(5) << 1e9 * t.secondsPerCall() << " нс/вызов"
+                << defaultfloat << "\n";
+        }
+    }
+};
+
+inline OperatorReport &operatorReport() {
+    static OperatorReport r;
+    return r;
+}
+
+struct OperatorBandit {
+    static constexpr int UPDATE_EVERY = 256;      // выборов между пересчётами вероятностей
+    static constexpr long long TIME_EVERY = 16;   // для отчёта замеряется каждый 16-й вызов оператора
+    static constexpr double DECAY = 0.999;        // память оценки — порядка тысячи вызовов оператора
+
+    vector<string> names;
+    shared_ptr<vector<OperatorStats>> stats; // заводится при первом выборе — копии ещё не работавшего бандита счётчики не делят
+    vector<double> recentGain, recentUses;   // забываемые сумма принятого выигрыша и число вызовов
+    vector<double> cumulative;               // накопленные вероятности выбора
+    int sinceUpdate = 0;
+    uniform_real_distribution<double> unit{0.0, 1.0};
+
+    explicit OperatorBandit(vector<string> names_)
+        : names(move(names_)), recentGain(names.size(), 0.0), recentUses(names.size(), 0.0),
+          cumulative(names.size())
+    {
+        for (size_t k = 0; k < names.size(); ++k) cumulative[k] = double(k + 1) / names.size();
+    }
+
+    // Выбрать оператор k и сыграть им: applyArm(k) применяет ход и возвращает его запись.
+    // Выигрыш засчитывается позже, через credit — если движок ход примет
+    template <class F>
+    MoveRecord pull(mt19937 &rng, F &&applyArm) {
+        if (!stats) stats = operatorReport().add(names);
+        if (++sinceUpdate == UPDATE_EVERY) update();
+
+        double u = unit(rng);
+        int k = int(upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin());
+        k = min(k, (int)cumulative.size() - 1);
+
+        OperatorStats &op = (*stats)[k];
+        bool timed = op.uses % TIME_EVERY == 0;
+        chrono::steady_clock::time_point start;
+        if (timed) start = chrono::steady_clock::now();
+        MoveRecord rec = applyArm(k);
+        if (timed) {
+            op.timedSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            op.timedCalls++;
+        }
+
+        op.uses++;
+        recentGain[k] *= DECAY;
+        recentUses[k] = recentUses[k] * DECAY + 1.0;
+        return rec;
+    }
+
+    // принятый ход оператора k уменьшил K1 на gain
+    void credit(int k, double gain) {
+        OperatorStats &op = (*stats)[k];
+        op.improving++;
+        op.gain += gain;
+        recentGain[k] += gain;
+    }
+
+private:
+    // вероятности ~ выгода на вызов, с полом 1/(4K); пока выигрыша нет ни у кого — поровну
+    void update() {
+        sinceUpdate = 0;
+        int K = (int)names.size();
+        double floor = 1.0 / (4 * K);
+        double total = 0;
+        for (int k = 0; k < K; ++k) {
+            cumulative[k] = recentUses[k] > 0 ? recentGain[k] / recentUses[k] : 0.0;
+            total += cumulative[k];
+        }
+        double acc = 0;
+        for (int k = 0; k < K; ++k) {
+            acc += total > 0 ? floor + (1.0 - K * floor) * cumulative[k] / total : 1.0 / K;
+            cumulative[k] = acc;
+        }
+    }
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Независимые потоки случайных чисел ------------------------------
+// Все генераторы запуска выводятся из одного мастер-сида: сид подпотока — хеш SplitMix64
+// от (сид родителя, номер подпотока). Деление можно вкладывать (эпоха -> поток), соседние
+// номера дают некоррелированные сиды, а общего состояния между потоками нет вовсе.
+
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// сид подпотока index внутри потока parent
+inline uint64_t splitSeed(uint64_t parent, uint64_t index) {
+    return splitmix64(parent ^ splitmix64(index));
+}
+
+// 32-битный сид для движков ИО; 0 у них означает «взять random_device», поэтому его избегаем
+inline uint32_t engineSeed(uint64_t s) {
+    uint32_t v = uint32_t(s ^ (s >> 32));
+    return v ? v : 1;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SA_X86_SIMD 1
+#endif
+
+using namespace std;
+
+// ------------------------------ SIMD-ядра полного пересчёта K1 ------------------------------
+// Полный пересчёт (стартовое решение, проверка индекса, перестройка раскладки) сводится к двум
+// проходам: сумма длительностей работ каждого процессора (сбор w[job] по индексам) и редукция
+// max(load) / min(head) по M процессорам. Оба прохода есть в трёх вариантах — скалярном, AVX2
+// и AVX-512; нужный выбирается один раз при первом вызове по возможностям процессора.
+// Загрузки и первые работы лежат в выровненных массивах (структура массивов, по 64 байта).
+
+// Аллокатор с выравниванием на границу кэш-линии — под векторные загрузки
+template <class T, size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <class U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <class U> AlignedAllocator(const AlignedAllocator<U, Align> &) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(::operator new(n * sizeof(T), align_val_t(Align)));
+    }
+    void deallocate(T *p, size_t) { ::operator delete(p, align_val_t(Align)); }
+
+    template <class U> bool operator==(const AlignedAllocator<U, Align> &) const { return true; }
+    template <class U> bool operator!=(const AlignedAllocator<U, Align> &) const { return false; }
+};
+
+using AlignedInts = vector<int, AlignedAllocator<int>>;
+
+namespace simd {
+
+// ---- скалярные версии (они же эталон для векторных) ----
+
+// сумма w[idx[0..n)]
+inline int gatherSumScalar(const int *w, const int *idx, int n) {
+    int s = 0;
+    for (int k = 0; k < n; ++k) s += w[idx[k]];
+    return s;
+}
+
+// max load[j] по процессорам с head[j] != emptyHead и min head[j] по всем
+inline void loadHeadExtremaScalar(const int *load, const int *head, int M, int emptyHead,
+                                  int &maxLoad, int &minHead) {
+    int mx = numeric_limits<int>::min(), mn = numeric_limits<int>::max();
+    for (int j = 0; j < M; ++j) {
+        if (head[j] != emptyHead) mx = max(mx, load[j]);
+        mn = min(mn, head[j]);
+    }
+    maxLoad = mx;
+    minHead = mn;
+}
+
+#ifdef SA_X86_SIMD
+
+__attribute__((target("avx2")))
+inline int gatherSumAvx2(const int *w, const int *idx, int n) {
+    __m256i acc = _mm256_setzero_si256();
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i ix = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + k));
+        acc = _mm256_add_epi32(acc, _mm256_i32gather_epi32(w, ix, 4));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s) + gatherSumScalar(w, idx + k, n - k);
+}
+
+__attribute__((target("avx2")))
+inline void loadHeadExtremaAvx2(const int *load, const int *head, int M, int emptyHead,
+                                int &maxLoad, int &minHead) {
+    const __m256i none = _mm256_set1_epi32(emptyHead);
+    const __m256i lowest = _mm256_set1_epi32(numeric_limits<int>::min());
+    __m256i mx = lowest, mn = _mm256_set1_epi32(numeric_limits<int>::max());
+    int j = 0;
+    for (; j + 8 <= M; j += 8) {
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(load + j));
+        __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(head + j));
+        // пустой процессор не участвует в максимуме загрузки
+        l = _mm256_blendv_epi8(l, lowest, _mm256_cmpeq_epi32(h, none));
+        mx = _mm256_max_epi32(mx, l);
+        mn = _mm256_min_epi32(mn, h);
+    }
+    alignas(32) int bufMax[8], bufMin[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(bufMax), mx);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(bufMin), mn);
+    loadHeadExtremaScalar(load + j, head + j, M - j, emptyHead, maxLoad, minHead);
+    for (int k = 0; k < 8; ++k) {
+        maxLoad = max(maxLoad, bufMax[k]);
+        minHead = min(minHead, bufMin[k]);
+    }
+}
+
+// GCC 12 ложно предупреждает о неинициализированном _mm512_undefined_* в интринсиках AVX-512,
+// встроенных в функции с target(...) (ошибка GCC 105593; так же в lockstep_engine.h)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f")))
+inline int gatherSumAvx512(const int *w, const int *idx, int n) {
+    __m512i acc = _mm512_setzero_si512();
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m512i ix = _mm512_loadu_si512(idx + k);
+        acc = _mm512_add_epi32(acc, _mm512_i32gather_epi32(ix, w, 4));
+    }
+    alignas(64) int buf[16];
+    _mm512_store_si512(buf, acc);
+    int s = gatherSumScalar(w, idx + k, n - k);
+    for (int v : buf) s += v;
+    return s;
+}
+
+__attribute__((target("avx512f")))
+inline void loadHeadExtremaAvx512(const int *load, const int *head, int M, int emptyHead,
+                                  int &maxLoad, int &minHead) {
+    const __m512i none = _mm512_set1_epi32(emptyHead);
+    __m512i mx = _mm512_set1_epi32(numeric_limits<int>::min());
+    __m512i mn = _mm512_set1_epi32(numeric_limits<int>::max());
+    int j = 0;
+    for (; j + 16 <= M; j += 16) {
+        __m512i l = _mm512_loadu_si512(load + j);
+        __m512i h = _mm512_loadu_si512(head + j);
+        mx = _mm512_mask_max_epi32(mx, _mm512_cmpneq_epi32_mask(h, none), mx, l);
+        mn = _mm512_min_epi32(mn, h);
+    }
+    alignas(64) int bufMax[16], bufMin[16];
+    _mm512_store_si512(bufMax, mx);
+    _mm512_store_si512(bufMin, mn);
+    loadHeadExtremaScalar(load + j, head + j, M - j, emptyHead, maxLoad, minHead);
+    for (int k = 0; k < 16; ++k) {
+        maxLoad = max(maxLoad, bufMax[k]);
+        minHead = min(minHead, bufMin[k]);
+    }
+}
+
+#pragma GCC diagnostic pop
+#endif
+
+// ---- выбор реализации во время выполнения ----
+
+struct Kernels {
+    int (*gatherSum)(const int *, const int *, int);
+    void (*loadHeadExtrema)(const int *, const int *, int, int, int &, int &);
+    const char *name;
+};
+
+inline Kernels detectKernels() {
+#ifdef SA_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return {gatherSumAvx512, loadHeadExtremaAvx512, "avx512"};
+    if (__builtin_cpu_supports("avx2")) return {gatherSumAvx2, loadHeadExtremaAvx2, "avx2"};
+#endif
+    return {gatherSumScalar, loadHeadExtremaScalar, "scalar"};
+}
+
+// набор ядер текущего процессора (определяется один раз, потокобезопасно)
+inline const Kernels &kernels() {
+    static const Kernels k = detectKernels();
+    return k;
+}
+
+inline int gatherSum(const int *w, const int *idx, int n) { return kernels().gatherSum(w, idx, n); }
+
+inline void loadHeadExtrema(const int *load, const int *head, int M, int emptyHead, int &maxLoad, int &minHead) {
+    kernels().loadHeadExtrema(load, head, M, emptyHead, maxLoad, minHead);
+}
+
+} // namespace simd
@@ -6,50 +6,62 @@ struct ScheduleSolution : Solution {
     // на каждом процессоре порядок выполнения задан вектором jobLists[j].
     int N; // число работ
     int M; // число процессоров
-    vector<int> w; // длительности работ w[i], расположены по индексам. По индексу работы получаю её время
+    JobDurations w; // длительности работ w[i], расположены по индексам. По индексу работы получаю её время (общая таблица экземпляра)
     vector<vector<int>> jobLists; // jobLists[j] - список индексов работ на процессоре j
+    K1Index index; // загрузки и первые работы процессоров, поддерживаются swapJobs/moveJob
 
     ScheduleSolution() = default;
 
-    ScheduleSolution(int N_, int M_, const vector<int> &w_) : N(N_), M(M_), w(w_) {
+    ScheduleSolution(int N_, int M_, JobDurations w_) : N(N_), M(M_), w(move(w_)) {
         jobLists.assign(M, {});
         // по умолчанию стартовая случайная раздача: round-robin
         for (int i = 0; i < N; ++i) {
             jobLists[i % M].push_back(i);
         }
+        rebuildIndex();
+    }
+
+    // готовая раздача работ по процессорам (см. initializers.h)
+    ScheduleSolution(int N_, int M_, JobDurations w_, vector<vector<int>> jobLists_)
+        : N(N_), M(M_), w(move(w_)), jobLists(move(jobLists_)) {
+        rebuildIndex();
     }
     
-    // глубокая копия
+    // глубокая копия (таблица длительностей общая)
     unique_ptr<Solution> clone() const override {
         auto s = make_unique<ScheduleSolution>();
         s->N = N; s->M = M; s->w = w;
         s->jobLists = jobLists;
+        s->index = index;
         return s;
     }
 
+    // векторы того же размера присваиваются поэлементно — без выделений памяти; таблица длительностей не копируется
+    void copyFrom(const Solution &other) override {
+        *this = dynamic_cast<const ScheduleSolution &>(other);
+    }
+
+    // пересобрать индекс K1 после прямого изменения jobLists
+    void rebuildIndex() { index.build(jobLists, w.data()); }
+
+    // число работ на процессоре p (общий интерфейс раскладок для мутаций)
+    int cpuSize(int p) const { return jobLists[p].size(); }
+    int job(int p, int i) const { return jobLists[p][i]; }
 
-    // Вычисление значения целевой функции. В нашем случае это критерий K1, который стараемся минимизировать
+
+    // Вычисление значения целевой функции. В нашем случае это критерий K1, который стараемся минимизировать.
+    // Берётся из индекса за O(1); полный пересчёт — fullCriteria().
     double criteria() const override {
-        // Массив всех времен завершения всех работ
-        vector<int> finishTimes;
-    
-        // Идём по всем процессорам
-        for (int j = 0; j < M; ++j) {
-            int currentTime = 0;
-
-            // Идём по работам на этом процессоре
-            for (int job : jobLists[j]) {
-                currentTime += w[job];      // прибавляем длительность работы
-                finishTimes.push_back(currentTime); // фиксируем момент её завершения
-            }
-        }
-    
-        if (finishTimes.empty()) return 0.0;
-    
-        int Tmax = *max_element(finishTimes.begin(), finishTimes.end());
-        int Tmin = *min_element(finishTimes.begin(), finishTimes.end());
-    
-        return double(Tmax - Tmin);
+        return index.k1();
+    }
+
+    // K1 полным проходом по всем работам (для проверки индекса).
+    // Моменты завершения на процессоре только растут, поэтому Tmax — максимальная загрузка,
+    // а Tmin — минимальная первая работа: хватает M загрузок и M первых работ, без массива всех finishTimes.
+    double fullCriteria() const {
+        AlignedInts loads, heads;
+        K1Index::measure(jobLists, w.data(), loads, heads);
+        return K1Index::k1Of(loads, heads);
     }
 
     // текстовое представление решения
@@ -74,22 +86,47 @@ struct ScheduleSolution : Solution {
         return oss.str();
     }
 
-    // утилиты: переместить работу из (p_from, idx_in_from) в (p_to, pos)
-    void moveJob(int p_from, int idx_in_from, int p_to, int pos) {
-        if (p_from < 0 || p_from >= M || p_to < 0 || p_to >= M) return;
-        if (idx_in_from < 0 || idx_in_from >= (int)jobLists[p_from].size()) return;
+    // утилиты: переместить работу из (p_from, idx_in_from) в (p_to, pos).
+    // Возвращает новое значение K1, пересчитанное за O(log M).
+    double moveJob(int p_from, int idx_in_from, int p_to, int pos) {
+        if (p_from < 0 || p_from >= M || p_to < 0 || p_to >= M) return criteria();
+        if (idx_in_from < 0 || idx_in_from >= (int)jobLists[p_from].size()) return criteria();
         int job = jobLists[p_from][idx_in_from];
         jobLists[p_from].erase(jobLists[p_from].begin() + idx_in_from);
         if (pos < 0) pos = 0;
         if (pos > (int)jobLists[p_to].size()) pos = jobLists[p_to].size();
         jobLists[p_to].insert(jobLists[p_to].begin() + pos, job);
+
+        if (p_from != p_to) {
+            refreshCpu(p_from, index.load[p_from] - w[job]);
+            refreshCpu(p_to, index.load[p_to] + w[job]);
+        } else if (idx_in_from == 0 || pos == 0) {
+            refreshCpu(p_from, index.load[p_from]);
+        }
+        return criteria();
     }
 
-    // swap двух работ (p1,i1) и (p2,i2)
-    void swapJobs(int p1, int i1, int p2, int i2) {
-        if (p1 < 0 || p1 >= M || p2 < 0 || p2 >= M) return;
-        if (i1 < 0 || i1 >= (int)jobLists[p1].size()) return;
-        if (i2 < 0 || i2 >= (int)jobLists[p2].size()) return;
+    // swap двух работ (p1,i1) и (p2,i2). Возвращает новое значение K1.
+    double swapJobs(int p1, int i1, int p2, int i2) {
+        if (p1 < 0 || p1 >= M || p2 < 0 || p2 >= M) return criteria();
+        if (i1 < 0 || i1 >= (int)jobLists[p1].size()) return criteria();
+        if (i2 < 0 || i2 >= (int)jobLists[p2].size()) return criteria();
         std::swap(jobLists[p1][i1], jobLists[p2][i2]);
+
+        if (p1 != p2) {
+            int diff = w[jobLists[p1][i1]] - w[jobLists[p2][i2]]; // на p1 пришла работа с p2
+            if (diff == 0) return criteria(); // равные длительности: загрузки и первые работы те же
+            refreshCpu(p1, index.load[p1] + diff);
+            refreshCpu(p2, index.load[p2] - diff);
+        } else if (i1 == 0 || i2 == 0) {
+            refreshCpu(p1, index.load[p1]);
+        }
+        return criteria();
+    }
+
+private:
+    void refreshCpu(int p, int newLoad) {
+        int h = jobLists[p].empty() ? K1Index::NO_HEAD : w[jobLists[p].front()];
+        index.set(p, newLoad, h);
     }
 };
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Пул решений ------------------------------
+// Свободный список отработавших решений. Пул принадлежит одному движку, а движок — одному потоку,
+// поэтому блокировок нет и потоки не делят между собой malloc. copyOf берёт решение из списка и
+// копирует в него src через copyFrom: векторы там уже нужного размера, и копия обходится без
+// выделений памяти. Пока список пуст, copyOf — обычный clone().
+struct SolutionPool {
+    vector<unique_ptr<Solution>> freeList;
+
+    unique_ptr<Solution> copyOf(const Solution &src) {
+        if (freeList.empty()) return src.clone();
+        unique_ptr<Solution> s = move(freeList.back());
+        freeList.pop_back();
+        s->copyFrom(src);
+        return s;
+    }
+
+    // вернуть ненужное решение; его память пойдёт под следующую копию
+    void recycle(unique_ptr<Solution> s) {
+        if (s) freeList.push_back(move(s));
+    }
+};
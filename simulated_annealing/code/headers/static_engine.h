@@ -0,0 +1,217 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ ИО со статической диспетчеризацией ------------------------------
+// Тот же цикл, что SimulatedAnnealing::runInPlace, но типы решения, мутации и закона охлаждения
+// известны при компиляции: в горячем цикле нет виртуальных вызовов и dynamic_cast, всё инлайнится.
+// Требования к типам:
+//   Sol  — раскладка расписания (ScheduleSolution / FlatScheduleSolution), criteria()
+//   Mut  — applyFilteredTo(Sol&, rng) -> MoveRecord, redoOn(Sol&, rec), undoOn(Sol&, rec)
+//          и acceptedOn(rec, gain) — принятый ход уменьшил K1 на gain (см. Mutation::accepted)
+//   Cool — nextTemperature(T, iter)
+
+// Смесь мутаций с равновероятным выбором — статический аналог CompositeMutation
+template <class... Ms>
+struct MutationMix {
+    tuple<Ms...> muts;
+
+    template <class S>
+    MoveRecord applyTo(S &s, mt19937 &rng) const {
+        uniform_int_distribution<int> dist(0, (int)sizeof...(Ms) - 1);
+        return applyAt(s, rng, dist(rng), index_sequence_for<Ms...>{});
+    }
+
+    template <class S>
+    MoveRecord applyFilteredTo(S &s, mt19937 &rng) const {
+        uniform_int_distribution<int> dist(0, (int)sizeof...(Ms) - 1);
+        return applyFilteredAt(s, rng, dist(rng), index_sequence_for<Ms...>{});
+    }
+
+    // запись хранит адрес сработавшей мутации — по нему и откатываем (и применяем заново)
+    template <class S>
+    void undoOn(S &s, const MoveRecord &rec) const {
+        undoAt(s, rec, index_sequence_for<Ms...>{});
+    }
+
+    template <class S>
+    void redoOn(S &s, const MoveRecord &rec) const {
+        redoAt(s, rec, index_sequence_for<Ms...>{});
+    }
+
+    void acceptedOn(const MoveRecord &, double) const {}
+
+protected:
+    template <class S, size_t... I>
+    MoveRecord applyAt(S &s, mt19937 &rng, int k, index_sequence<I...>) const {
+        MoveRecord rec;
+        ((k == (int)I ? (rec = get<I>(muts).applyTo(s, rng), 0) : 0), ...);
+        return rec;
+    }
+
+    template <class S, size_t... I>
+    MoveRecord applyFilteredAt(S &s, mt19937 &rng, int k, index_sequence<I...>) const {
+        MoveRecord rec;
+        ((k == (int)I ? (rec = get<I>(muts).applyFilteredTo(s, rng), 0) : 0), ...);
+        return rec;
+    }
+
+    template <class S, size_t... I>
+    void undoAt(S &s, const MoveRecord &rec, index_sequence<I...>) const {
+        ((rec.by == &get<I>(muts) ? (get<I>(muts).undoOn(s, rec), 0) : 0), ...);
+    }
+
+    template <class S, size_t... I>
+    void redoAt(S &s, const MoveRecord &rec, index_sequence<I...>) const {
+        ((rec.by == &get<I>(muts) ? (get<I>(muts).redoOn(s, rec), 0) : 0), ...);
+    }
+};
+
+// Та же смесь с адаптивными долями — статический аналог AdaptiveMutation. Бандит — часть значения:
+// у каждого движка своя копия смеси, а с ней и своя статистика
+template <class... Ms>
+struct AdaptiveMix : MutationMix<Ms...> {
+    mutable OperatorBandit bandit{{Ms().name()...}};
+
+    template <class S>
+    MoveRecord applyTo(S &s, mt19937 &rng) const {
+        return bandit.pull(rng, [&](int k) { return this->applyAt(s, rng, k, index_sequence_for<Ms...>{}); });
+    }
+
+    template <class S>
+    MoveRecord applyFilteredTo(S &s, mt19937 &rng) const {
+        return bandit.pull(rng, [&](int k) { return this->applyFilteredAt(s, rng, k, index_sequence_for<Ms...>{}); });
+    }
+
+    void acceptedOn(const MoveRecord &rec, double gain) const {
+        creditAt(rec, gain, index_sequence_for<Ms...>{});
+    }
+
+private:
+    template <size_t... I>
+    void creditAt(const MoveRecord &rec, double gain, index_sequence<I...>) const {
+        ((rec.by == &get<I>(this->muts) ? (bandit.credit(I, gain), 0) : 0), ...);
+    }
+};
+
+template <class Sol, class Mut, class Cool>
+struct StaticSimulatedAnnealing {
+    double T0;
+    int maxIterations;
+    int noImproveLimit;
+    double lowerBound = 0; // нижняя граница K1: достигнута — отжиг останавливается
+    bool currentEnergy = false; // эталон — K1 текущего решения (как currentEnergy параллельного SimulatedAnnealing, headers_parallel/head_class_parallel.h)
+    Cool cooling;
+    Mut mutation;
+    TemperatureTable temperatures;
+    mt19937 rng;
+    uniform_real_distribution<double> unit{0.0, 1.0}; // Metropolis-тест берёт числа из своего rng, не из rand()
+    SA_TM(shared_ptr<EngineTelemetry> tm = telemetry().add();)
+
+    StaticSimulatedAnnealing(double T0_, int maxIter_, int noImproveLimit_,
+                             Cool cooling_, Mut mutation_ = Mut(), uint32_t seed = 0)
+        : T0(T0_), maxIterations(maxIter_), noImproveLimit(noImproveLimit_),
+          cooling(move(cooling_)), mutation(move(mutation_)), temperatures(T0_)
+    {
+        if (seed == 0) {
+            random_device rd;
+            seed = rd();
+        }
+        rng.seed(seed);
+    }
+
+    unique_ptr<Sol> run(const Sol &initial) {
+        auto current = make_unique<Sol>(initial);
+        runInPlace(*current);
+        return current;
+    }
+
+    // Отжиг решения current на месте. Правило приёма то же, что в SimulatedAnnealing.
+    void runInPlace(Sol &current) {
+        AnnealState st = begin(current);
+        step(current, st, numeric_limits<long long>::max());
+    }
+
+    AnnealState begin(const Sol &s) const {
+        AnnealState st;
+        st.T = T0;
+        st.reference = s.criteria();
+        return st;
+    }
+
+    // отжиг продолжается: не исчерпаны итерации и терпение и не достигнута нижняя граница
+    bool running(const AnnealState &st) const {
+        return st.iter < maxIterations && st.noImprove < noImproveLimit && st.reference > lowerBound;
+    }
+
+    // Не более steps итераций с состояния st; false — отжиг закончился (см. running)
+    bool step(Sol &current, AnnealState &st, long long steps) {
+        SA_TM(TmStopwatch sw;)
+        for (long long k = 0; k < steps && running(st); ++k) {
+            // нейтральный ход K1 не меняет: его не применяют и не оценивают заранее, решение — по текущему K1,
+            // применяется только принятый. Числа из rng и решения те же, что при apply + undo
+            double before = current.criteria();
+            MoveRecord rec = mutation.applyFilteredTo(current, rng);
+            SA_TM(if (rec.neutral) tm->neutral++;)
+            double new_criteria = current.criteria();
+
+            if (new_criteria < st.reference) {
+                st.reference = new_criteria;
+                st.noImprove = 0;
+                mutation.acceptedOn(rec, before - new_criteria);
+                SA_TM(tm->improving++;)
+            } else if (metropolisAccept(new_criteria - st.reference, st.T, rng, unit)) {
+                if (rec.neutral) mutation.redoOn(current, rec);
+                if (new_criteria < before) mutation.acceptedOn(rec, before - new_criteria);
+                if (currentEnergy) st.reference = new_criteria;
+                st.noImprove = 0;
+                SA_TM(tm->acceptedWorse++;)
+            } else {
+                if (!rec.neutral) mutation.undoOn(current, rec);
+                st.noImprove++;
+                SA_TM(tm->rejected++;)
+            }
+
+            ++st.iter;
+            st.T = temperatures.next(cooling, st.T, st.iter);
+            SA_TM(tm->tick(st.T, current);)
+        }
+        SA_TM(tm->annealSeconds += sw.lap();)
+        return running(st);
+    }
+};
+
+// Вызывает f с конкретным законом охлаждения по его имени (неизвестное имя — Cauchy, как в main)
+template <class F>
+decltype(auto) withCooling(const string &coolingType, double T0, F &&f) {
+    if (coolingType == "Boltzmann") return f(BoltzmannCooling(T0));
+    if (coolingType == "Mixed") return f(MixedCooling(T0));
+    if (coolingType == "Constant") return f(ConstantCooling(T0));
+    return f(CauchyCooling(T0));
+}
+
+// Вызывает f со смесью мутаций по её имени — статический аналог makeMutation (неизвестное имя — uniform)
+template <class F>
+decltype(auto) withMutationMix(const string &kind, F &&f) {
+    if (kind == "guided") return f(MutationMix<SwapTwoJobs, MoveJob, MoveFromCritical, SwapMinHead>());
+    if (kind == "adaptive") return f(AdaptiveMix<SwapTwoJobs, MoveJob, MoveFromCritical, SwapMinHead>());
+    return f(MutationMix<SwapTwoJobs, MoveJob>());
+}
+
+// Выбор конкретных типов по параметрам запуска делается один раз здесь; дальше всё статически.
+// Набор мутаций — тот же, что makeMutation(mutations) в main.
+unique_ptr<Solution> runStaticAnnealing(const Solution &initial, const string &coolingType, double T0,
+                                        int maxIter, int noImproveLimit, uint32_t seed = 0,
+                                        double lowerBound = 0, const string &mutations = "uniform") {
+    return withCooling(coolingType, T0, [&](auto cooling) {
+        return withMutationMix(mutations, [&](auto mix) {
+            return withSchedule(initial, [&](const auto &sch) -> unique_ptr<Solution> {
+                using Sol = decay_t<decltype(sch)>;
+                StaticSimulatedAnnealing<Sol, decltype(mix), decltype(cooling)>
+                    sa(T0, maxIter, noImproveLimit, cooling, mix, seed);
+                sa.lowerBound = lowerBound;
+                return sa.run(sch);
+            });
+        });
+    });
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Телеметрия отжига ------------------------------
+// Включается при сборке ключом -DSA_TELEMETRY. Без него макрос SA_TM(...) раскрывается в пустоту:
+// ни полей, ни счётчиков, ни вызовов часов в горячем цикле не остаётся.
+// Каждый движок ИО регистрирует свой EngineTelemetry и считает в нём:
+//   proposals      — оценённые кандидаты (в пакетном режиме — все K кандидатов шага);
+//   improving      — ходы, улучшившие эталон; acceptedWorse — принятые не улучшающие (в т.ч. нейтральные);
+//   rejected       — отвергнутые; neutral — из них всех ходы, заведомо не менявшие K1 (не применялись до приёма);
+//   annealSeconds  — время внутри циклов отжига;
+//   busy/waitSeconds — работа и ожидание на барьере (рабочие потоки эпох);
+//   trace          — кольцевой буфер сэмплов (итерация, T, K1) раз в TRACE_EVERY кандидатов.
+// Управляющий поток эпох добавляет длительность каждой эпохи. В конце всё выгружается в JSON.
+
+#ifdef SA_TELEMETRY
+#define SA_TM(...) __VA_ARGS__
+#else
+#define SA_TM(...)
+#endif
+
+#ifdef SA_TELEMETRY
+
+struct TraceSample {
+    long long iter;
+    double T;
+    double k1;
+};
+
+struct EngineTelemetry {
+    static constexpr int TRACE_CAPACITY = 4096;     // хранятся последние 4096 сэмплов
+    static constexpr long long TRACE_EVERY = 1024;  // сэмпл на каждые 1024 кандидата (степень двойки)
+
+    string label;
+    long long proposals = 0, improving = 0, acceptedWorse = 0, rejected = 0, neutral = 0;
+    double annealSeconds = 0, busySeconds = 0, waitSeconds = 0;
+    vector<TraceSample> trace = vector<TraceSample>(TRACE_CAPACITY);
+    long long traced = 0;
+
+    // конец итерации: n оценённых кандидатов; K1 берётся из решения только при сэмпле
+    template <class S>
+    void tick(double T, const S &s, int n = 1) {
+        long long before = proposals;
+        proposals += n;
+        if ((before & ~(TRACE_EVERY - 1)) != (proposals & ~(TRACE_EVERY - 1)))
+            trace[traced++ % TRACE_CAPACITY] = {proposals, T, s.criteria()};
+    }
+};
+
+// Секундомер: lap() — секунд с прошлого lap() (или с создания)
+struct TmStopwatch {
+    chrono::steady_clock::time_point last = chrono::steady_clock::now();
+
+    double lap() {
+        auto now = chrono::steady_clock::now();
+        double s = chrono::duration<double>(now - last).count();
+        last = now;
+        return s;
+    }
+};
+
+// Все движки запуска и длительности эпох
+struct TelemetryRegistry {
+    mutex m;
+    vector<shared_ptr<EngineTelemetry>> engines;
+    vector<double> epochSeconds;
+
+    shared_ptr<EngineTelemetry> add() {
+        lock_guard<mutex> lock(m);
+        auto t = make_shared<EngineTelemetry>();
+        t->label = "engine " + to_string(engines.size());
+        engines.push_back(t);
+        return t;
+    }
+
+    void writeJSON(ostream &out) {
+        lock_guard<mutex> lock(m);
+        out << "{\n  \"engines\": [\n";
+        for (size_t e = 0; e < engines.size(); ++e) {
+            const EngineTelemetry &t = *engines[e];
+            out << "    {\"label\": \"" << t.label << "\", \"proposals\": " << t.proposals
+                << ", \"improving\": " << t.improving << ", \"accepted_worse\": " << t.acceptedWorse
+                << ", \"rejected\": " << t.rejected << ", \"neutral\": " << t.neutral << ", \"anneal_seconds\": " << t.annealSeconds
+                << ", \"evals_per_second\": " << (t.annealSeconds > 0 ? t.proposals / t.annealSeconds : 0.0)
+                << ", \"busy_seconds\": " << t.busySeconds << ", \"wait_seconds\": " << t.waitSeconds
+                << ",\n     \"trace\": [";
+            // кольцо выгружается от старых сэмплов к новым
+            long long first = max(0LL, t.traced - EngineTelemetry::TRACE_CAPACITY);
+            for (long long k = first; k < t.traced; ++k) {
+                const TraceSample &s = t.trace[k % EngineTelemetry::TRACE_CAPACITY];
+                out << (k > first ? ", " : "") << "[" << s.iter << ", " << s.T << ", " << s.k1 << "]";
+            }
+            out << "]}" << (e + 1 < engines.size() ? "," : "") << "\n";
+        }
+        out << "  ],\n  \"epoch_seconds\": [";
+        for (size_t i = 0; i < epochSeconds.size(); ++i) out << (i ? ", " : "") << epochSeconds[i];
+        out << "]\n}\n";
+    }
+};
+
+inline TelemetryRegistry &telemetry() {
+    static TelemetryRegistry r;
+    return r;
+}
+
+#endif
+
+// Выгрузить телеметрию запуска в файл path (main вызывает по ключу --telemetry=path)
+inline void exportTelemetry(const string &path) {
+#ifdef SA_TELEMETRY
+    ofstream out(path);
+    if (!out.is_open()) {
+        cerr << "Не удалось открыть файл телеметрии: " << path << "\n";
+        return;
+    }
+    telemetry().writeJSON(out);
+    cerr << "Телеметрия записана в " << path << "\n";
+#else
+    cerr << "Телеметрия не собрана: пересоберите с -DSA_TELEMETRY (" << path << " не записан)\n";
+#endif
+}
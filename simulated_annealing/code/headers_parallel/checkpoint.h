@@ -0,0 +1,349 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Контрольные точки параллельного ИО ------------------------------
+// Между эпохами состояние запуска целиком описывается лучшим решением, счётчиком эпох без улучшения
+// и состояниями генераторов рабочих потоков (каждая эпоха начинается с T0 и iter = 0).
+// Управляющий поток отдаёт это отдельному потоку CheckpointWriter как CheckpointSnapshot — ссылку
+// на неизменяемое лучшее решение и генераторы; сборку Checkpoint (списки работ по процессорам),
+// сериализацию и запись на диск делает писатель. Файл пишется во временный path.tmp
+// и переименовывается — на диске всегда лежит целая контрольная точка, старая или новая.
+// Продолжение с контрольной точки с тем же числом потоков даёт тот же результат, что и прогон без остановки.
+// Исключение — --mutations=adaptive: статистика бандитов (operator_bandit.h) не сохраняется и набирается заново.
+// Эпоха на большом экземпляре может идти дольше интервала контрольных точек, поэтому снимок снимается
+// и посреди эпохи (MidEpochSnapshots): лучшее из текущих решений потоков и их генераторы. Продолжение
+// с такого снимка начинает новую эпоху с этого решения — результат уже не совпадает бит в бит с непрерывным.
+
+struct Checkpoint {
+    // параметры запуска
+    int N = 0, M = 0;
+    JobDurations w;
+    string layout, coolingType, engine;
+    string mutations = "uniform";
+    double T0 = 0;
+    int maxIter = 0, noImproveLimit = 0;
+    int batchSize = 1;
+    bool batchBestOfK = true;
+    int Nproc = 0;
+    uint64_t masterSeed = 0;
+
+    // состояние между эпохами
+    long long epoch = 0;
+    int globalNoImprove = 0;
+    vector<vector<int>> bestLists; // лучшее решение: работы каждого процессора по порядку
+    vector<mt19937> rngs;          // генератор рабочего потока i (в файле — текстом через operator<<)
+};
+
+// работы каждого процессора по порядку — для любой раскладки
+vector<vector<int>> jobListsOf(const Solution &s) {
+    return withSchedule(s, [](const auto &sch) {
+        vector<vector<int>> lists(sch.M);
+        for (int p = 0; p < sch.M; ++p)
+            for (int i = 0; i < sch.cpuSize(p); ++i) lists[p].push_back(sch.job(p, i));
+        return lists;
+    });
+}
+
+// ---- двоичный формат: сигнатура, затем поля подряд; строки и векторы — с длиной впереди ----
+const char CHECKPOINT_MAGIC[8] = {'S', 'A', 'C', 'K', 'P', 'T', '0', '2'};
+
+struct CheckpointOut {
+    ostream &out;
+    template <class T> void pod(const T &v) { out.write(reinterpret_cast<const char *>(&v), sizeof(T)); }
+    void str(const string &s) { pod<uint64_t>(s.size()); out.write(s.data(), s.size()); }
+    template <class V> void ints(const V &v) { // vector<int> или JobDurations
+        pod<uint64_t>(v.size());
+        out.write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(int));
+    }
+};
+
+struct CheckpointIn {
+    istream &in;
+    template <class T> T pod() {
+        T v;
+        if (!in.read(reinterpret_cast<char *>(&v), sizeof(T))) throw runtime_error("Ошибка: контрольная точка обрезана");
+        return v;
+    }
+    uint64_t size() {
+        uint64_t n = pod<uint64_t>();
+        if (n > (1ULL << 34)) throw runtime_error("Ошибка: контрольная точка повреждена");
+        return n;
+    }
+    string str() {
+        string s(size(), '\0');
+        if (!in.read(s.data(), s.size())) throw runtime_error("Ошибка: контрольная точка обрезана");
+        return s;
+    }
+    vector<int> ints() {
+        vector<int> v(size());
+        if (!in.read(reinterpret_cast<char *>(v.data()), v.size() * sizeof(int)))
+            throw runtime_error("Ошибка: контрольная точка обрезана");
+        return v;
+    }
+};
+
+void writeCheckpoint(const string &path, const Checkpoint &c) {
+    string tmp = path + ".tmp";
+    {
+        ofstream f(tmp, ios::binary | ios::trunc);
+        if (!f.is_open()) throw runtime_error("Не удалось открыть файл для записи: " + tmp);
+        CheckpointOut o{f};
+        f.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        o.pod(c.N); o.pod(c.M); o.ints(c.w);
+        o.str(c.layout); o.str(c.coolingType); o.str(c.engine); o.str(c.mutations);
+        o.pod(c.T0); o.pod(c.maxIter); o.pod(c.noImproveLimit);
+        o.pod(c.batchSize); o.pod<uint8_t>(c.batchBestOfK);
+        o.pod(c.Nproc); o.pod(c.masterSeed);
+        o.pod(c.epoch); o.pod(c.globalNoImprove);
+        o.pod<uint64_t>(c.bestLists.size());
+        for (const auto &l : c.bestLists) o.ints(l);
+        o.pod<uint64_t>(c.rngs.size());
+        for (const auto &r : c.rngs) {
+            ostringstream ss;
+            ss << r;
+            o.str(ss.str());
+        }
+        f.flush();
+        if (!f) throw runtime_error("Ошибка записи файла: " + tmp);
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0)
+        throw runtime_error("Не удалось переименовать " + tmp + " в " + path);
+}
+
+// Расписание из файла должно быть целым: N длительностей и каждая из работ 0..N-1 ровно один раз
+void checkCheckpointSchedule(const Checkpoint &c) {
+    if (c.N < 0 || c.M <= 0 || (int)c.w.size() != c.N)
+        throw runtime_error("Ошибка: контрольная точка повреждена (N=" + to_string(c.N) + ", M=" + to_string(c.M) +
+                            ", длительностей " + to_string(c.w.size()) + ")");
+    vector<char> seen(c.N, 0);
+    size_t total = 0;
+    for (const auto &l : c.bestLists) {
+        for (int job : l) {
+            if (job < 0 || job >= c.N || seen[job])
+                throw runtime_error("Ошибка: контрольная точка повреждена (работа " + to_string(job) +
+                                    " вне 0..N-1 или повторяется)");
+            seen[job] = 1;
+        }
+        total += l.size();
+    }
+    if (total != size_t(c.N))
+        throw runtime_error("Ошибка: контрольная точка повреждена (в расписании " + to_string(total) +
+                            " работ из " + to_string(c.N) + ")");
+}
+
+Checkpoint readCheckpoint(const string &path) {
+    ifstream f(path, ios::binary);
+    if (!f.is_open()) throw runtime_error("Не удалось открыть файл: " + path);
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    if (!f.read(magic, sizeof(magic)) || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0)
+        throw runtime_error("Ошибка: это не контрольная точка (нет сигнатуры SACKPT02)");
+
+    CheckpointIn in{f};
+    Checkpoint c;
+    c.N = in.pod<int>(); c.M = in.pod<int>(); c.w = JobDurations(in.ints());
+    c.layout = in.str(); c.coolingType = in.str(); c.engine = in.str(); c.mutations = in.str();
+    c.T0 = in.pod<double>(); c.maxIter = in.pod<int>(); c.noImproveLimit = in.pod<int>();
+    c.batchSize = in.pod<int>(); c.batchBestOfK = in.pod<uint8_t>();
+    c.Nproc = in.pod<int>(); c.masterSeed = in.pod<uint64_t>();
+    c.epoch = in.pod<long long>(); c.globalNoImprove = in.pod<int>();
+    c.bestLists.resize(in.size());
+    for (auto &l : c.bestLists) l = in.ints();
+    c.rngs.resize(in.size());
+    for (auto &r : c.rngs) {
+        istringstream ss(in.str());
+        if (!(ss >> r)) throw runtime_error("Ошибка: контрольная точка повреждена");
+    }
+    if ((int)c.bestLists.size() != c.M || (int)c.rngs.size() != c.Nproc)
+        throw runtime_error("Ошибка: контрольная точка повреждена");
+    checkCheckpointSchedule(c);
+    return c;
+}
+
+// То, что меняется от контрольной точки к контрольной точке. Решение best не меняется, пока снимок
+// у писателя (CheckpointWriter::uses): снять его — O(1) плюс копия генераторов
+struct CheckpointSnapshot {
+    shared_ptr<const Solution> best;
+    long long epoch = 0;
+    int globalNoImprove = 0;
+    vector<mt19937> rngs;
+};
+
+// Контрольная точка из параметров запуска и снимка; O(N) — вызывается в потоке писателя
+Checkpoint assembleCheckpoint(const Checkpoint &params, const CheckpointSnapshot &snap) {
+    Checkpoint c = params;
+    withSchedule(*snap.best, [&](const auto &s) {
+        c.N = s.N;
+        c.M = s.M;
+        c.w = s.w; // общая таблица — без копии
+        c.layout = is_same_v<decay_t<decltype(s)>, FlatScheduleSolution> ? "flat" : "lists";
+    });
+    c.epoch = snap.epoch;
+    c.globalNoImprove = snap.globalNoImprove;
+    c.bestLists = jobListsOf(*snap.best);
+    c.rngs = snap.rngs;
+    return c;
+}
+
+// Фоновая запись: submit отдаёт снимок и сразу возвращается. Если писатель ещё занят,
+// ожидающий снимок заменяется более свежим — на диск попадает последнее состояние.
+struct CheckpointWriter {
+    string path;
+    Checkpoint params; // параметры запуска; остальное — из снимка
+    mutex m;
+    condition_variable cv;
+    unique_ptr<CheckpointSnapshot> pending, writing;
+    bool done = false;
+    thread worker;
+
+    CheckpointWriter(string path_, Checkpoint params_) : path(move(path_)), params(move(params_)) {
+        worker = thread([this] {
+            unique_lock<mutex> lock(m);
+            while (true) {
+                cv.wait(lock, [this] { return pending || done; });
+                if (!pending) return;
+                writing = move(pending);
+                lock.unlock();
+                try {
+                    writeCheckpoint(path, assembleCheckpoint(params, *writing));
+                } catch (const exception &e) {
+                    cerr << "Контрольная точка не записана: " << e.what() << "\n";
+                }
+                lock.lock();
+                writing.reset();
+            }
+        });
+    }
+
+    void submit(unique_ptr<CheckpointSnapshot> snap) {
+        {
+            lock_guard<mutex> lock(m);
+            pending = move(snap);
+        }
+        cv.notify_one();
+    }
+
+    // решение s ещё нужно писателю (ждёт записи или пишется) — менять его на месте нельзя
+    bool uses(const Solution *s) {
+        lock_guard<mutex> lock(m);
+        return (pending && pending->best.get() == s) || (writing && writing->best.get() == s);
+    }
+
+    // дописывает последний снимок и останавливает поток
+    ~CheckpointWriter() {
+        {
+            lock_guard<mutex> lock(m);
+            done = true;
+        }
+        cv.notify_one();
+        worker.join();
+    }
+};
+
+// Настройки контрольных точек для parallelSimulatedAnnealing
+struct CheckpointOptions {
+    string path;                       // пусто — контрольные точки не пишутся
+    double everySeconds = 60;          // не чаще, чем раз в столько секунд (между эпохами и посреди эпохи)
+    const Checkpoint *resume = nullptr; // продолжить с этой контрольной точки
+};
+
+// Снимки посреди эпохи. Рабочие отжигают порциями по CHUNK итераций и после каждой смотрят на часы.
+// Первый заметивший, что срок подошёл, объявляет запрос; каждый ещё работающий поток на ближайшей
+// границе порции кладёт копию своего решения и генератора (копирует вне мьютекса). Закончивший эпоху
+// отвечает итоговым решением без копии — до следующего барьера оно не меняется. Последний ответивший
+// выбирает лучшее из base (globalBest) и ответов — O(число потоков) под мьютексом — и отдаёт его в ready
+// вместе с генераторами: копия потока уходит целиком, итог закончившего эпоху клонируется уже вне
+// мьютекса. Сборку и запись контрольной точки делает CheckpointWriter.
+struct MidEpochSnapshots {
+    static constexpr long long CHUNK = 4096; // итераций отжига между проверками часов
+
+    using Ready = function<void(shared_ptr<const Solution> best, vector<mt19937> rngs)>;
+
+    const shared_ptr<Solution> &base;            // globalBest: не меняется, пока идёт эпоха
+    const vector<unique_ptr<Solution>> &scratch; // итоговые решения закончивших эпоху потоков
+    const vector<mt19937 *> &rngs;               // и их генераторы
+    Ready ready;
+    long long everyNs;
+    atomic<long long> dueNs;  // время следующего снимка по steady_clock
+
+    mutex m;
+    atomic<long long> requested{0}; // номер последнего запроса (меняется под m)
+    int pending = 0;                // потоков, ещё не ответивших на него
+    vector<long long> served;       // последний запрос, на который ответил поток (или который его не касался)
+    vector<char> finished;    // поток закончил текущую эпоху
+    vector<unique_ptr<Solution>> copies; // copies[i] пишет поток i, пока не ответил на открытый запрос
+    vector<mt19937> copyRngs;
+
+    MidEpochSnapshots(const shared_ptr<Solution> &base_, const vector<unique_ptr<Solution>> &scratch_,
+                      const vector<mt19937 *> &rngs_, double everySeconds, Ready ready_)
+        : base(base_), scratch(scratch_), rngs(rngs_), ready(move(ready_)), everyNs(llround(everySeconds * 1e9)),
+          dueNs(nowNs() + everyNs), served(scratch_.size(), 0), finished(scratch_.size(), 0),
+          copies(scratch_.size()), copyRngs(scratch_.size()) {}
+
+    static long long nowNs() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool due() const { return nowNs() >= dueNs.load(memory_order_relaxed); }
+
+    // потоку i пора вызвать publish: подошёл срок или есть запрос, на который он ещё не ответил
+    bool wanted(int i) const { return served[i] < requested.load(memory_order_relaxed) || due(); }
+    void postpone() { dueNs.store(nowNs() + everyNs, memory_order_relaxed); }
+
+    // управляющий поток между эпохами, пока рабочие стоят на барьере. Запросы прошлой эпохи собраны:
+    // закончившие её раньше запроса в нём не участвовали и отвечать на него не должны
+    void startEpoch() {
+        fill(finished.begin(), finished.end(), 0);
+        fill(served.begin(), served.end(), requested.load());
+    }
+
+    // поток i посреди эпохи, когда wanted(i): ответить на запрос (или объявить его) решением s
+    void publish(int i, const Solution &s, const mt19937 &rng) {
+        {
+            lock_guard<mutex> lock(m);
+            if (served[i] == requested) {
+                if (!due()) return; // запрос уже собран, срок сдвинут
+                ++requested;
+                postpone();
+                pending = count(finished.begin(), finished.end(), 0);
+            }
+        }
+        // запрос ждёт ответа потока i, поэтому copies[i] никто, кроме него, сейчас не читает
+        if (copies[i]) copies[i]->copyFrom(s);
+        else copies[i] = s.clone();
+        copyRngs[i] = rng;
+        unique_lock<mutex> lock(m);
+        serve(i, lock);
+    }
+
+    // поток i закончил эпоху; его итоговое решение — ответ на ещё не отвеченный запрос
+    void finish(int i) {
+        unique_lock<mutex> lock(m);
+        finished[i] = 1;
+        if (served[i] < requested) serve(i, lock);
+    }
+
+private:
+    void serve(int i, unique_lock<mutex> &lock) {
+        served[i] = requested;
+        if (--pending > 0) return;
+        const Solution *best = base.get();
+        int from = -1;
+        vector<mt19937> rs;
+        for (size_t j = 0; j < scratch.size(); ++j) {
+            const Solution *s = finished[j] ? scratch[j].get() : copies[j].get();
+            if (s->criteria() < best->criteria()) {
+                best = s;
+                from = j;
+            }
+            rs.push_back(finished[j] ? *rngs[j] : copyRngs[j]);
+        }
+        shared_ptr<const Solution> owned;
+        if (from < 0) owned = base;
+        else if (!finished[from]) owned = move(copies[from]); // следующий publish склонирует заново
+        lock.unlock();
+        // итог закончившего эпоху потока: этот поток ещё не дошёл до барьера, так что решение на месте
+        if (!owned) owned = best->clone();
+        ready(move(owned), move(rs));
+    }
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Барьер эпох ------------------------------
+// Многоразовый барьер на count участников (std::barrier есть только с C++20).
+// Все вызвавшие arriveAndWait() ждут, пока не придёт последний, после чего барьер готов к следующему кругу.
+class EpochBarrier {
+    private:
+        mutex m;
+        condition_variable cv;
+        int count;
+        int waiting = 0;
+        uint64_t generation = 0;
+    public:
+        explicit EpochBarrier(int count_) : count(count_) {}
+
+        void arriveAndWait() {
+            unique_lock<mutex> lock(m);
+            uint64_t gen = generation;
+            if (++waiting == count) {
+                waiting = 0;
+                ++generation;
+                cv.notify_all();
+                return;
+            }
+            cv.wait(lock, [&] { return gen != generation; });
+        }
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Асинхронная островная модель ------------------------------
+// Каждый поток («остров») отжигает своё решение непрерывно, без общих эпох и барьеров.
+// Раз в migrationInterval итераций остров публикует свой лучший результат в слот миграции
+// и забирает решение из входящего слота, если оно лучше его собственного.
+// Топологии: ring — остров i пишет в свой слот и читает слот острова i-1;
+//            broadcast — один общий слот, в котором всегда лежит лучшее из опубликованного.
+
+// Буфер снимка в слоте миграции. Решение создаётся при первой записи и дальше переиспользуется (copyFrom).
+// pins — число читателей, закрепивших буфер, или WRITING и больше, пока буфер захвачен писателем
+struct MigrantBuffer {
+    static constexpr int WRITING = 1 << 30;
+    atomic<int> pins{0};
+    atomic<double> k1{numeric_limits<double>::infinity()};
+    unique_ptr<Solution> solution;
+};
+
+// Закреплённый читателем снимок: пока жив, его буфер не перезаписывается
+class MigrantLease {
+    MigrantBuffer *buf = nullptr;
+
+public:
+    MigrantLease() = default;
+    explicit MigrantLease(MigrantBuffer *b) : buf(b) {}
+    MigrantLease(MigrantLease &&o) noexcept : buf(exchange(o.buf, nullptr)) {}
+    MigrantLease &operator=(MigrantLease &&) = delete;
+    ~MigrantLease() {
+        if (buf) buf->pins.fetch_sub(1);
+    }
+
+    explicit operator bool() const { return buf != nullptr; }
+    double k1() const { return buf->k1.load(memory_order_relaxed); }
+    const Solution &solution() const { return *buf->solution; }
+};
+
+// Слот миграции без блокировок. Снимки лежат в буферах слота, текущий задаёт слово current:
+// номер буфера и счётчик версий (версия не даёт CAS-у спутать буфер, успевший смениться и вернуться).
+// Читатель закрепляет буфер (pins + 1), перепроверяет current и только потом читает. Писатель
+// захватывает лишь свободный буфер — CAS pins 0 -> WRITING у не текущего, — так что закреплённый
+// снимок не перезаписывается никогда. Каждый из users потоков слота держит не больше одного буфера,
+// ещё один — текущий, поэтому буферов users + 2 и свободный находится всегда.
+// Публикация — CAS current только на снимок с меньшим K1: в слоте никогда не окажется решение хуже
+// уже лежащего. Проверка «есть ли что-то лучше» — чтение атомика k1Hint без закрепления; k1Hint только
+// убывает (CAS-минимум), поэтому поток, проигравший гонку за слот, не поднимет его выше лежащего снимка.
+struct MigrationSlot {
+    static constexpr uint64_t INDEX_BITS = 16;
+    static constexpr uint64_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint64_t EMPTY = INDEX_MASK; // в слоте ещё ничего не опубликовано
+
+    atomic<double> k1Hint{numeric_limits<double>::infinity()};
+    atomic<uint64_t> current{EMPTY};
+    unique_ptr<MigrantBuffer[]> buffers;
+    int count;
+
+    explicit MigrationSlot(int users) : buffers(make_unique<MigrantBuffer[]>(users + 2)), count(users + 2) {}
+
+    void publish(const Solution &s, double k1) {
+        if (k1 >= k1Hint.load(memory_order_relaxed)) return;
+        int b = claim();
+        MigrantBuffer &buf = buffers[b];
+        if (buf.solution) buf.solution->copyFrom(s);
+        else buf.solution = s.clone();
+        buf.k1.store(k1, memory_order_relaxed);
+
+        uint64_t cur = current.load();
+        while (true) {
+            uint64_t idx = cur & INDEX_MASK;
+            // k1 текущего буфера мог смениться, но тогда сменилось и current, и CAS ниже не пройдёт
+            if (idx != EMPTY && buffers[idx].k1.load(memory_order_relaxed) <= k1) break;
+            uint64_t next = (((cur >> INDEX_BITS) + 1) << INDEX_BITS) | uint64_t(b);
+            if (current.compare_exchange_weak(cur, next)) {
+                double hint = k1Hint.load(memory_order_relaxed);
+                while (k1 < hint && !k1Hint.compare_exchange_weak(hint, k1, memory_order_release,
+                                                                  memory_order_relaxed)) {}
+                break;
+            }
+        }
+        buf.pins.fetch_sub(MigrantBuffer::WRITING); // теперь буфер можно закреплять
+    }
+
+    // закреплённый снимок, если в слоте есть решение лучше threshold, иначе пустой
+    MigrantLease takeIfBetter(double threshold) {
+        if (k1Hint.load(memory_order_acquire) >= threshold) return {};
+        while (true) {
+            uint64_t cur = current.load();
+            uint64_t idx = cur & INDEX_MASK;
+            if (idx == EMPTY) return {};
+            MigrantBuffer &buf = buffers[idx];
+            if (buf.pins.fetch_add(1) < MigrantBuffer::WRITING && current.load() == cur) {
+                if (buf.k1.load(memory_order_relaxed) < threshold) return MigrantLease(&buf);
+                buf.pins.fetch_sub(1);
+                return {};
+            }
+            buf.pins.fetch_sub(1); // буфер уже сменился или ещё дописывается — повторить
+        }
+    }
+
+private:
+    // свободный буфер, захваченный для записи
+    int claim() {
+        while (true) {
+            for (int b = 0; b < count; ++b) {
+                int expected = 0;
+                if ((current.load() & INDEX_MASK) == uint64_t(b) ||
+                    !buffers[b].pins.compare_exchange_strong(expected, MigrantBuffer::WRITING))
+                    continue;
+                // между проверкой и захватом буфер мог стать текущим — тогда отпустить
+                if ((current.load() & INDEX_MASK) != uint64_t(b)) return b;
+                buffers[b].pins.fetch_sub(MigrantBuffer::WRITING);
+            }
+        }
+    }
+};
+
+void islandSimulatedAnnealing(
+    const Solution &initial,
+    int Nproc,
+    double T0,
+    int maxIter,
+    int noImproveLimit,
+    shared_ptr<Mutation> mutation,
+    const string &coolingType,
+    uint64_t masterSeed,
+    const EngineOptions &eo,
+    int migrationInterval,  // итераций отжига между обменами
+    const string &topology  // ring | broadcast
+) {
+    const int maxStaleRounds = 30; // остров останавливается после 30 обменов подряд без улучшения
+
+    bool broadcast = topology == "broadcast";
+    deque<MigrationSlot> slots; // ring: пишет остров i, читает i + 1; broadcast: все острова
+    for (int k = 0; k < (broadcast ? 1 : Nproc); ++k) slots.emplace_back(broadcast ? Nproc : 2);
+    vector<unique_ptr<Solution>> islandBest(Nproc);
+    vector<double> islandBestK1(Nproc);
+
+    mutex logMutex; // только для печати нового глобального рекорда
+    atomic<double> globalBestK1{initial.criteria()};
+
+    vector<thread> islands;
+    for (int i = 0; i < Nproc; ++i) {
+        islands.emplace_back([&, i]() {
+            Annealer annealer = makeAnnealer(initial, eo, coolingType, T0, maxIter, noImproveLimit,
+                                             mutation, engineSeed(splitSeed(masterSeed, i)));
+            MigrationSlot &out = slots[broadcast ? 0 : i];
+            MigrationSlot &in = slots[broadcast ? 0 : (i + Nproc - 1) % Nproc];
+
+            auto current = initial.clone();
+            auto best = initial.clone();
+            double bestK1 = best->criteria();
+            AnnealState st = annealer.begin(*current);
+
+            // острова останавливаются и тогда, когда любой из них дошёл до нижней границы
+            for (int stale = 0; stale < maxStaleRounds && globalBestK1.load() > eo.lowerBound; ) {
+                bool running = annealer.step(*current, st, migrationInterval);
+
+                double k1 = current->criteria();
+                if (k1 < bestK1) {
+                    bestK1 = k1;
+                    best->copyFrom(*current);
+                    out.publish(*best, bestK1);
+                    stale = 0;
+
+                    double g = globalBestK1.load();
+                    while (k1 < g && !globalBestK1.compare_exchange_weak(g, k1)) {}
+                    if (k1 < g) {
+                        lock_guard<mutex> lock(logMutex);
+                        std::cerr << "[Island " << i << "] New global best = " << k1 << std::endl;
+                    }
+                } else {
+                    stale++;
+                }
+
+                if (auto migrant = in.takeIfBetter(bestK1)) {
+                    // пришло решение лучше нашего — продолжаем отжиг с него
+                    bestK1 = migrant.k1();
+                    best->copyFrom(migrant.solution());
+                    current->copyFrom(*best);
+                    st = annealer.begin(*current);
+                    stale = 0;
+                } else if (!running) {
+                    // цикл отжига остановился по noImproveLimit — новый заход с лучшего решения острова
+                    current->copyFrom(*best);
+                    st = annealer.begin(*current);
+                }
+            }
+
+            islandBest[i] = move(best);
+            islandBestK1[i] = bestK1;
+        });
+    }
+
+    for (auto &t : islands) t.join();
+
+    int winner = min_element(islandBestK1.begin(), islandBestK1.end()) - islandBestK1.begin();
+    std::cout << islandBest[winner]->toString();
+    std::cout << gapReport(islandBestK1[winner], eo.lowerBound) << std::endl;
+}
@@ -1,60 +1,182 @@
 using namespace std;
 
 // ------------------------------ Параллельная реализация ------------------------------
+
+// Отжигатель одного рабочего потока. Движок вместе со своим законом охлаждения и rng создаётся
+// один раз на весь запуск и переживает эпохи. begin/step — отжиг порциями (как у движков),
+// anneal — целиком до noImproveLimit.
+struct Annealer {
+    function<AnnealState(const Solution&)> begin;
+    function<bool(Solution&, AnnealState&, long long)> step;
+    mt19937 *rng; // генератор движка — для контрольных точек
+    SA_TM(shared_ptr<EngineTelemetry> tm;) // телеметрия движка этого потока
+
+    void anneal(Solution &s) {
+        AnnealState st = begin(s);
+        step(s, st, numeric_limits<long long>::max());
+    }
+};
+
+// Настройки движка рабочих потоков (общие для эпох, островов и реплик)
+struct EngineOptions {
+    string engine = "virtual";  // virtual | static
+    int batchSize = 1;          // кандидатов на шаг, только для virtual (см. SimulatedAnnealing::batchedMove)
+    bool batchBestOfK = true;   // правило выбора из пачки: лучший из K или первый принятый
+    double lowerBound = 0;      // нижняя граница K1 экземпляра: её достижение останавливает и движок, и запуск
+    string mutations = "uniform"; // набор мутаций static-движка (для virtual мутация передаётся готовой)
+    bool currentEnergy = false;   // Metropolis против K1 текущего решения, а не эталона (реплики tempering)
+};
+
+Annealer makeAnnealer(const Solution &shape, const EngineOptions &eo, const string &coolingType,
+                      double T0, int maxIter, int noImproveLimit,
+                      shared_ptr<Mutation> mutation, uint32_t seed) {
+    if (eo.engine == "static") {
+        return withCooling(coolingType, T0, [&](auto cooling) {
+            return withMutationMix(eo.mutations, [&](auto mix) {
+                return withSchedule(shape, [&](const auto &sch) -> Annealer {
+                    using Sol = decay_t<decltype(sch)>;
+                    using Engine = StaticSimulatedAnnealing<Sol, decltype(mix), decltype(cooling)>;
+                    // параллельная версия останавливается только по noImproveLimit
+                    auto sa = make_shared<Engine>(T0, numeric_limits<int>::max(), noImproveLimit, cooling, mix, seed);
+                    sa->lowerBound = eo.lowerBound;
+                    sa->currentEnergy = eo.currentEnergy;
+                    return {
+                        [sa](const Solution &s) { return sa->begin(static_cast<const Sol&>(s)); },
+                        [sa](Solution &s, AnnealState &st, long long steps) { return sa->step(static_cast<Sol&>(s), st, steps); },
+                        &sa->rng,
+                        SA_TM(sa->tm)
+                    };
+                });
+            });
+        });
+    }
+    auto sa = make_shared<SimulatedAnnealing>(T0, maxIter, noImproveLimit, makeCoolingLaw(coolingType, T0), mutation, seed);
+    sa->batchSize = eo.batchSize;
+    sa->batchBestOfK = eo.batchBestOfK;
+    sa->lowerBound = eo.lowerBound;
+    sa->currentEnergy = eo.currentEnergy;
+    return {
+        [sa](const Solution &s) { return sa->begin(s); },
+        [sa](Solution &s, AnnealState &st, long long steps) { return sa->step(s, st, steps); },
+        &sa->rng,
+        SA_TM(sa->tm)
+    };
+}
+
+// Эпоха: все потоки стартуют с globalBest, после чего лучший из результатов становится новым globalBest.
+// Потоки создаются один раз и живут весь запуск; эпохи раздаются через барьер.
+// Контрольная точка снимается между эпохами управляющим потоком, а если эпоха длиннее
+// интервала — и посреди неё, по ответам рабочих (MidEpochSnapshots в checkpoint.h).
 void parallelSimulatedAnnealing(
-    const ScheduleSolution &initial,
+    const Solution &initial,
     int Nproc,
     double T0,
     int maxIter,
     int noImproveLimit,
     shared_ptr<Mutation> mutation,
-    const string &coolingType
+    const string &coolingType,
+    uint64_t masterSeed,             // поток i берёт сид splitSeed(masterSeed, i)
+    const EngineOptions &eo = {},
+    const CheckpointOptions &ck = {}
 ) {
-    mutex globalMutex;
-    auto globalBest = initial.clone();
+    shared_ptr<Solution> globalBest = initial.clone(); // пока снимок у писателя, заменяется, а не перезаписывается
     double globalBestCriteria = globalBest->criteria();
 
-    int globalNoImprove = 0;
+    int globalNoImprove = ck.resume ? ck.resume->globalNoImprove : 0;
+    long long epoch = ck.resume ? ck.resume->epoch : 0;
     const int maxGlobalNoImprove = 30; // критерий останова по ТЗ
 
-    while (globalNoImprove < maxGlobalNoImprove) {
-        vector<thread> threads;
-        vector<unique_ptr<Solution>> localBest(Nproc);
+    // генераторы рабочих потоков; читаются управляющим только между эпохами, пока рабочие стоят на барьере
+    vector<mt19937 *> rngs(Nproc);
 
-        for (int i = 0; i < Nproc; ++i) {
-            threads.emplace_back([&, i]() {
-                random_device rd;
-                uint32_t seed = rd() + i * 100;
-
-                // Так как каждый поток обязан иметь свои копии объектов, а не указатели на какие-то в памяти
-                unique_ptr<CoolingLaw> cooling;
-                if (coolingType == "Boltzmann")
-                    cooling = make_unique<BoltzmannCooling>(T0);
-                else if (coolingType == "Mixed")
-                    cooling = make_unique<MixedCooling>(T0);
-                else
-                    cooling = make_unique<CauchyCooling>(T0);
-
-                // каждый поток работает со своей копией текущего лучшего
-                auto localInitial = dynamic_cast<ScheduleSolution*>(globalBest->clone().release());
-                SimulatedAnnealing sa(T0, maxIter, noImproveLimit, move(cooling), mutation, seed);
-
-                auto result = sa.run(*localInitial);
-                localBest[i] = move(result);
-
-                delete localInitial;
+    // рабочее решение каждого потока; память переиспользуется из эпохи в эпоху
+    vector<unique_ptr<Solution>> scratch(Nproc);
+    for (auto &s : scratch) s = initial.clone();
+
+    // вызывающий поток только отдаёт снимок (ссылку на решение и генераторы); сборка и запись — у писателя
+    unique_ptr<CheckpointWriter> writer;
+    auto submitCheckpoint = [&](shared_ptr<const Solution> best, int noImprove, vector<mt19937> workerRngs) {
+        auto snap = make_unique<CheckpointSnapshot>();
+        snap->best = move(best);
+        snap->epoch = epoch;
+        snap->globalNoImprove = noImprove;
+        snap->rngs = move(workerRngs);
+        writer->submit(move(snap));
+    };
+
+    // посреди эпохи globalBest, epoch и globalNoImprove не меняются — управляющий поток стоит на барьере
+    unique_ptr<MidEpochSnapshots> snaps;
+    if (!ck.path.empty()) {
+        Checkpoint params;
+        params.coolingType = coolingType;
+        params.engine = eo.engine;
+        params.mutations = eo.mutations;
+        params.T0 = T0;
+        params.maxIter = maxIter;
+        params.noImproveLimit = noImproveLimit;
+        params.batchSize = eo.batchSize;
+        params.batchBestOfK = eo.batchBestOfK;
+        params.Nproc = Nproc;
+        params.masterSeed = masterSeed;
+        writer = make_unique<CheckpointWriter>(ck.path, move(params));
+        snaps = make_unique<MidEpochSnapshots>(globalBest, scratch, rngs, ck.everySeconds,
+            [&](shared_ptr<const Solution> best, vector<mt19937> workerRngs) {
+                int noImprove = best == globalBest ? globalNoImprove : 0;
+                submitCheckpoint(move(best), noImprove, move(workerRngs));
             });
-        }
+    }
 
-        for (auto &t : threads) t.join();
+    // Nproc рабочих + управляющий поток. Между двумя барьерами идёт эпоха,
+    // вне её рабочие спят, а управляющий сливает результаты.
+    EpochBarrier barrier(Nproc + 1);
+    bool stop = false;
+
+    vector<thread> pool;
+    for (int i = 0; i < Nproc; ++i) {
+        pool.emplace_back([&, i]() {
+            // собственный поток случайных чисел: тот же мастер-сид — тот же прогон бит в бит
+            Annealer annealer = makeAnnealer(initial, eo, coolingType, T0, maxIter, noImproveLimit,
+                                             mutation, engineSeed(splitSeed(masterSeed, i)));
+            if (ck.resume) *annealer.rng = ck.resume->rngs[i];
+            rngs[i] = annealer.rng;
+            SA_TM(annealer.tm->label = "thread " + to_string(i); TmStopwatch sw;)
+            while (true) {
+                barrier.arriveAndWait(); // старт эпохи
+                SA_TM(annealer.tm->waitSeconds += sw.lap();)
+                if (stop) break;
+                scratch[i]->copyFrom(*globalBest);
+                if (snaps) {
+                    // порциями, чтобы вовремя ответить на запрос снимка посреди эпохи
+                    AnnealState st = annealer.begin(*scratch[i]);
+                    while (annealer.step(*scratch[i], st, MidEpochSnapshots::CHUNK))
+                        if (snaps->wanted(i)) snaps->publish(i, *scratch[i], *annealer.rng);
+                    snaps->finish(i);
+                } else {
+                    annealer.anneal(*scratch[i]);
+                }
+                SA_TM(annealer.tm->busySeconds += sw.lap();)
+                barrier.arriveAndWait(); // конец эпохи
+                SA_TM(annealer.tm->waitSeconds += sw.lap();)
+            }
+        });
+    }
+
+    while (true) {
+        stop = globalNoImprove >= maxGlobalNoImprove || globalBestCriteria <= eo.lowerBound;
+        if (snaps) snaps->startEpoch();
+        barrier.arriveAndWait();
+        if (stop) break;
+        SA_TM(TmStopwatch epochTimer;)
+        barrier.arriveAndWait();
+        SA_TM(telemetry().epochSeconds.push_back(epochTimer.lap());)
 
         bool improved = false;
         for (int i = 0; i < Nproc; ++i) {
-            double crit = localBest[i]->criteria();
-            lock_guard<mutex> lock(globalMutex);
+            double crit = scratch[i]->criteria();
             if (crit < globalBestCriteria) {
                 globalBestCriteria = crit;
-                globalBest = localBest[i]->clone();
+                if (writer && writer->uses(globalBest.get())) globalBest = scratch[i]->clone();
+                else globalBest->copyFrom(*scratch[i]);
                 improved = true;
                 std::cerr << "[Iter] New global best = " << crit << std::endl;
             }
@@ -62,8 +184,19 @@ void parallelSimulatedAnnealing(
 
         if (improved) globalNoImprove = 0;
         else globalNoImprove++;
+        ++epoch;
+
+        if (snaps && snaps->due()) {
+            snaps->postpone();
+            vector<mt19937> workerRngs;
+            for (mt19937 *r : rngs) workerRngs.push_back(*r);
+            submitCheckpoint(globalBest, globalNoImprove, move(workerRngs));
+        }
     }
 
+    for (auto &t : pool) t.join();
+    writer.reset(); // дождаться записи последней контрольной точки
 
     std::cout << globalBest->toString();
-}
\ No newline at end of file
+    std::cout << gapReport(globalBestCriteria, eo.lowerBound) << std::endl;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Parallel tempering (обмен репликами) ------------------------------
+// R реплик расписания живут каждая при своей постоянной температуре из геометрической лестницы
+// Tmin .. Tmax. Раунд: каждая реплика делает sweep итераций Metropolis при своей T (мутации и K1
+// те же, что в отжиге), затем соседние по лестнице реплики пробуют обменяться состояниями:
+// обмен (i, i+1) принимается с вероятностью min(1, exp((1/T_i - 1/T_{i+1}) * (E_i - E_{i+1}))).
+// Реплика — настоящая цепочка Metropolis: ход сравнивается с K1 её текущего решения
+// (EngineOptions::currentEnergy), а состояние цепочки (энергия E) живёт между раундами и при обмене
+// переходит вместе с решением. Именно эта E и входит в критерий обмена.
+// Горячие реплики бродят по ландшафту, холодные дочищают найденное. Реплика r считается потоком r % Nproc.
+void parallelTempering(
+    const Solution &initial,
+    int Nproc,
+    int R,              // число реплик
+    double Tmin,        // температура самой холодной реплики
+    double Tmax,        // температура самой горячей реплики
+    int sweep,          // итераций Metropolis между обменами
+    shared_ptr<Mutation> mutation,
+    uint64_t masterSeed,
+    const EngineOptions &engineOpts
+) {
+    const int maxGlobalNoImprove = 30; // раундов без улучшения до остановки, как у эпох
+
+    R = max(R, 1);
+    Nproc = max(1, min(Nproc, R));
+    vector<double> ladder(R);
+    for (int r = 0; r < R; ++r)
+        ladder[r] = R == 1 ? Tmin : Tmin * pow(Tmax / Tmin, double(r) / (R - 1));
+
+    EngineOptions eo = engineOpts;
+    eo.currentEnergy = true;
+
+    vector<unique_ptr<Solution>> state(R); // state[r] — решение при температуре ladder[r]
+    for (auto &s : state) s = initial.clone();
+    vector<AnnealState> chain(R);          // chain[r] — состояние цепочки Metropolis при ladder[r], reference — её E
+
+    auto globalBest = initial.clone();
+    double globalBestCriteria = globalBest->criteria();
+    int globalNoImprove = 0;
+
+    EpochBarrier barrier(Nproc + 1);
+    bool stop = false;
+
+    vector<thread> pool;
+    for (int i = 0; i < Nproc; ++i) {
+        pool.emplace_back([&, i]() {
+            // у каждой реплики свой движок: постоянная температура и свой поток случайных чисел
+            vector<pair<int, Annealer>> mine;
+            for (int r = i; r < R; r += Nproc)
+                mine.emplace_back(r, makeAnnealer(initial, eo, "Constant", ladder[r], numeric_limits<int>::max(),
+                                                  numeric_limits<int>::max(), mutation,
+                                                  engineSeed(splitSeed(masterSeed, r))));
+            for (auto &[r, annealer] : mine) chain[r] = annealer.begin(*state[r]);
+            while (true) {
+                barrier.arriveAndWait();
+                if (stop) break;
+                for (auto &[r, annealer] : mine) {
+                    // T постоянна, а счётчики итераций нужны только для остановки — обнуляются каждый раунд
+                    chain[r].iter = 0;
+                    chain[r].noImprove = 0;
+                    annealer.step(*state[r], chain[r], sweep);
+                }
+                barrier.arriveAndWait();
+            }
+        });
+    }
+
+    mt19937 rng(engineSeed(splitSeed(masterSeed, R))); // поток для решений об обмене
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<long long> tried(max(R - 1, 1)), swapped(max(R - 1, 1));
+
+    for (int round = 0; ; ++round) {
+        stop = globalNoImprove >= maxGlobalNoImprove || globalBestCriteria <= eo.lowerBound;
+        barrier.arriveAndWait();
+        if (stop) break;
+        barrier.arriveAndWait();
+
+        vector<double> E(R);
+        bool improved = false;
+        for (int r = 0; r < R; ++r) {
+            E[r] = chain[r].reference; // == state[r]->criteria()
+            if (E[r] < globalBestCriteria) {
+                globalBestCriteria = E[r];
+                globalBest->copyFrom(*state[r]);
+                improved = true;
+            }
+        }
+        if (improved) {
+            globalNoImprove = 0;
+            std::cerr << "[Round " << round << "] New global best = " << globalBestCriteria << std::endl;
+        } else {
+            globalNoImprove++;
+        }
+
+        // чётные раунды меняют пары (0,1),(2,3)..., нечётные — (1,2),(3,4)...
+        for (int r = round % 2; r + 1 < R; r += 2) {
+            double delta = (1.0 / ladder[r] - 1.0 / ladder[r + 1]) * (E[r] - E[r + 1]);
+            tried[r]++;
+            if (delta >= 0 || unit(rng) < std::exp(delta)) {
+                swap(state[r], state[r + 1]);
+                swap(chain[r].reference, chain[r + 1].reference);
+                swapped[r]++;
+            }
+        }
+    }
+
+    for (auto &t : pool) t.join();
+
+    std::cerr << "Обмены реплик (T_i <-> T_i+1: принято/попыток):";
+    for (int r = 0; r + 1 < R; ++r) std::cerr << " " << swapped[r] << "/" << tried[r];
+    std::cerr << std::endl;
+
+    std::cout << globalBest->toString();
+    std::cout << gapReport(globalBestCriteria, eo.lowerBound) << std::endl;
+}
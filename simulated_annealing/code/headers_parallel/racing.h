@@ -0,0 +1,154 @@
+#pragma once
+
+using namespace std;
+
+// ------------------------------ Гонка цепочек (multi-start с отсевом) ------------------------------
+// C независимых цепочек отжига с разными сидами стартуют с одного решения и идут ступенями
+// (successive halving). На ступени каждая цепочка в гонке делает budget итераций, затем цепочки
+// ранжируются по лучшему K1: в гонке остаются ceil(n / eta) лидеров и все, кто делит с последним
+// из них одно значение K1 (неотличимых по критерию не снимаем), остальные снимаются.
+// Бюджет ступени на всех постоянен (rungSteps * C), поэтому с отсевом каждой выжившей цепочке
+// достаётся всё больше итераций. Когда выживших меньше, чем потоков, свободные слоты снятых цепочек
+// становятся копиями лидеров (то же решение и состояние отжига, новый поток случайных чисел) — ядра
+// продолжают работать на перспективные ветки, а не простаивают. Цепочка, остановившаяся по
+// noImproveLimit, из гонки не выбывает: она начинает новый заход отжига со своего лучшего решения
+// (как остров в island_model.h) и снимается только отсевом. Гонка кончается, когда 30 ступеней
+// подряд не улучшили общий рекорд или рекорд дошёл до нижней границы K1.
+// Какой поток взял какую цепочку, на результат не влияет: при том же мастер-сиде и числе потоков
+// прогон повторяется бит в бит.
+
+struct RaceChain {
+    Annealer annealer;
+    unique_ptr<Solution> current, best;
+    double bestK1;
+    AnnealState st;
+    bool racing = true; // false — снята отсевом
+};
+
+void racingSimulatedAnnealing(
+    const Solution &initial,
+    int Nproc,
+    int C,              // число цепочек на старте
+    double T0,
+    int maxIter,
+    int noImproveLimit,
+    shared_ptr<Mutation> mutation,
+    const string &coolingType,
+    uint64_t masterSeed, // цепочка c берёт сид splitSeed(masterSeed, c), копии — следующие номера
+    const EngineOptions &eo,
+    long long rungSteps, // итераций на цепочку на первой ступени
+    int eta              // на ступени остаётся 1 / eta цепочек
+) {
+    const int maxStaleRungs = 30; // ступеней без улучшения до остановки, как эпох у parallelSimulatedAnnealing
+
+    C = max(C, 1);
+    eta = max(eta, 2);
+    Nproc = max(1, min(Nproc, C));
+
+    vector<RaceChain> chains;
+    chains.reserve(C);
+    for (int c = 0; c < C; ++c) {
+        RaceChain ch{makeAnnealer(initial, eo, coolingType, T0, maxIter, noImproveLimit, mutation,
+                                  engineSeed(splitSeed(masterSeed, c))),
+                     initial.clone(), initial.clone(), initial.criteria(), {}};
+        ch.st = ch.annealer.begin(*ch.current);
+        SA_TM(ch.annealer.tm->label = "chain " + to_string(c);)
+        chains.push_back(move(ch));
+    }
+    uint64_t nextStream = C; // номер потока случайных чисел для следующей копии лидера
+
+    // цепочки ступени раздаются потокам через общий счётчик — кто освободился, берёт следующую
+    vector<int> active;
+    long long budget = 0;
+    atomic<size_t> nextTask{0};
+    EpochBarrier barrier(Nproc + 1);
+    bool stop = false;
+
+    vector<thread> pool;
+    for (int i = 0; i < Nproc; ++i) {
+        pool.emplace_back([&]() {
+            while (true) {
+                barrier.arriveAndWait();
+                if (stop) break;
+                for (size_t k; (k = nextTask.fetch_add(1)) < active.size();) {
+                    RaceChain &ch = chains[active[k]];
+                    bool running = ch.annealer.step(*ch.current, ch.st, budget);
+                    double k1 = ch.current->criteria();
+                    if (k1 < ch.bestK1) {
+                        ch.bestK1 = k1;
+                        ch.best->copyFrom(*ch.current);
+                    }
+                    if (!running) {
+                        // заход остановился по noImproveLimit — следующий начнётся с лучшего решения цепочки
+                        ch.current->copyFrom(*ch.best);
+                        ch.st = ch.annealer.begin(*ch.current);
+                    }
+                }
+                barrier.arriveAndWait();
+            }
+        });
+    }
+
+    double globalBestK1 = initial.criteria();
+    int staleRungs = 0;
+    for (int rung = 0; ; ++rung) {
+        active.clear();
+        for (int c = 0; c < (int)chains.size(); ++c)
+            if (chains[c].racing) active.push_back(c);
+        stop = active.empty() || staleRungs >= maxStaleRungs || globalBestK1 <= eo.lowerBound;
+        if (!stop) {
+            budget = max(rungSteps, rungSteps * C / (long long)active.size());
+            nextTask = 0;
+        }
+        barrier.arriveAndWait(); // старт ступени: active, budget и nextTask уже выставлены
+        if (stop) break;
+        SA_TM(TmStopwatch rungTime;)
+        barrier.arriveAndWait();
+        SA_TM(telemetry().epochSeconds.push_back(rungTime.lap());)
+
+        staleRungs++;
+        for (const auto &ch : chains)
+            if (ch.bestK1 < globalBestK1) {
+                globalBestK1 = ch.bestK1;
+                staleRungs = 0;
+                std::cerr << "[Race] New global best = " << globalBestK1 << std::endl;
+            }
+
+        // отсев среди цепочек ступени
+        vector<int> alive = active;
+        stable_sort(alive.begin(), alive.end(), [&](int a, int b) { return chains[a].bestK1 < chains[b].bestK1; });
+        size_t keep = (alive.size() + eta - 1) / eta;
+        double cutoff = chains[alive[keep - 1]].bestK1;
+        while (keep < alive.size() && chains[alive[keep]].bestK1 <= cutoff) ++keep;
+        for (size_t k = keep; k < alive.size(); ++k) chains[alive[k]].racing = false;
+        alive.resize(keep);
+
+        // свободные ядра — копиям лидеров; слоты берутся у снятых цепочек, чьи лучшие хуже лучшего у лидеров
+        int forks = 0;
+        for (int c = 0; c < (int)chains.size() && (int)alive.size() + forks < Nproc; ++c) {
+            RaceChain &slot = chains[c];
+            if (slot.racing || slot.bestK1 <= globalBestK1) continue;
+            const RaceChain &leader = chains[alive[forks % alive.size()]];
+            slot.current->copyFrom(*leader.current);
+            slot.best->copyFrom(*leader.best);
+            slot.bestK1 = leader.bestK1;
+            slot.st = leader.st;
+            slot.annealer.rng->seed(engineSeed(splitSeed(masterSeed, nextStream++)));
+            slot.racing = true;
+            ++forks;
+        }
+
+        std::cerr << "[Race] Ступень " << rung << ": " << budget << " итераций на цепочку, в гонке "
+                  << alive.size() << " (порог K1 = " << cutoff << ")";
+        if (forks) std::cerr << ", копий лидеров: " << forks;
+        std::cerr << std::endl;
+    }
+
+    for (auto &t : pool) t.join();
+
+    int winner = 0;
+    for (int c = 1; c < (int)chains.size(); ++c)
+        if (chains[c].bestK1 < chains[winner].bestK1) winner = c;
+    std::cout << chains[winner].best->toString();
+    std::cout << gapReport(chains[winner].bestK1, eo.lowerBound) << std::endl;
+}
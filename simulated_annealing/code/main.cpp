@@ -1,15 +1,29 @@
 /*
 Симуляция имитации отжига для задачи расписания N работ на M процессорах
-Компиляция: g++ -std=c++17 main.cpp -O2 -o main
+Компиляция: g++ -std=c++17 main.cpp -O2 -pthread -o main
 */
 
 #include <bits/stdc++.h>
 #include "headers/abstruct.h"
+#include "headers/simd_kernels.h"
+#include "headers/k1_index.h"
+#include "headers/job_durations.h"
 #include "headers/solution.h"
+#include "headers/flat_solution.h"
+#include "headers/solution_pool.h"
+#include "headers/initializers.h"
+#include "headers/lower_bound.h"
+#include "headers/operator_bandit.h"
 #include "headers/mutations.h"
 #include "headers/cooling_laws.h"
+#include "headers/telemetry.h"
 #include "headers/head_class.h"
+#include "headers/static_engine.h"
 #include "headers/data_io.h"
+#include "headers/cli_options.h"
+#include "headers/rng_streams.h"
+#include "headers/lockstep_engine.h"
+#include "headers/batch_runner.h"
 
 
 using namespace std;
@@ -20,7 +34,9 @@ using namespace std;
    - class Mutation (abstract): абстракция операции мутации (изменения решения).
    - class CoolingLaw (abstract): интерфейс закона понижения температуры.
    - class SimulatedAnnealing: главный класс, реализующий цикл ИО, принимает конкретные реализации выше.
-   - Конкретная реализация для задачи расписания: ScheduleSolution, конкретные мутации (Swap, Move).
+   - Конкретная реализация для задачи расписания: ScheduleSolution, конкретные мутации (Swap, Move;
+     направленные MoveFromCritical и SwapMinHead — с --mutations=guided, с адаптивными долями — adaptive).
+     Длительности работ (JobDurations) хранятся один раз на экземпляр, копии решения ссылаются на них.
    - Реализованы три закона понижения температуры: Exponential, Linear, Logarithmic.
 */
 
@@ -30,12 +46,21 @@ int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
+    Options opts = extractOptions(argc, argv);
+    string layout = opts.get("layout", "lists"); // lists | flat
+    string init = opts.get("init", "roundrobin"); // roundrobin | greedy | lpt | k1
+    string engine = opts.get("engine", "virtual"); // virtual | static | lockstep
+    string mutations = opts.get("mutations", "uniform"); // uniform | guided | adaptive
+    if (engine == "lockstep" && mutations != "uniform")
+        cerr << "Движок lockstep ходит только переносом и обменом: --mutations=" << mutations
+             << " действует лишь на экземплярах, не помещающихся в линии (они решаются static-движком).\n\n";
+
     int N = 5, M = 2;
     int minW = 1, maxW = 20;
-    uint32_t seed = 0;
+    uint32_t seed = opts.getInt("seed", 0); // 0 — случайный; напечатанный сид воспроизводит прогон
     string mode = "auto";        // режим по умолчанию
     string coolingType = "Cauchy";
-    vector<int> w;               // длительности работ
+    JobDurations w;              // длительности работ (общая таблица всех решений)
 
 
     random_device rd;
@@ -56,14 +81,14 @@ int main(int argc, char** argv) {
     if (argc == 1) {
         std::cout << "[Mode 1] Автоматическая генерация (по умолчанию)\n";
         N = 5; M = 2;
-        w = generateDurations(N, minW, maxW, rng);
+        w = JobDurations(generateDurations(N, minW, maxW, rng));
     }
     else if (argc == 5 && string(argv[1]) == "default") {
         std::cout << "[Mode 2] Аргументы командной строки\n";
         N = stoi(argv[2]);
         M = stoi(argv[3]);
         coolingType = argv[4];
-        w = generateDurations(N, minW, maxW, rng);
+        w = JobDurations(generateDurations(N, minW, maxW, rng));
     }
     else if (argc == 2 && string(argv[1]) == "manual") {
         std::cout << "[Mode 3] Ввод вручную" << std::endl;
@@ -72,13 +97,73 @@ int main(int argc, char** argv) {
         std::cout  << "Введите закон охлаждения (Cauchy / Boltzmann / Mixed): " << std::endl;
         cin >> coolingType;
         std::cout  << "Введите длительности " << N << " работ: " << std::endl;
-        w.resize(N);
-        for (int i = 0; i < N; ++i) cin >> w[i];
+        vector<int> typed(N);
+        for (int i = 0; i < N; ++i) cin >> typed[i];
+        w = JobDurations(typed);
+    }
+    else if (argc == 4 && string(argv[1]) == "convert") {
+        // CSV -> двоичный экземпляр; отжиг не запускается
+        try {
+            InputData data = readInstance(argv[2]);
+            writeBinary(argv[3], data);
+            std::cout << "Записан двоичный экземпляр " << argv[3] << " (N=" << data.w.size()
+                      << ", M=" << data.M << ")" << std::endl;
+            return 0;
+        }
+        catch (const exception &e) {
+            cerr << "Ошибка: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    else if (argc == 3 && string(argv[1]) == "batch") {
+        // все экземпляры каталога на пуле потоков; итоги — в один CSV
+        BatchSettings cfg;
+        cfg.layout = layout;
+        cfg.init = init;
+        cfg.engine = engine;
+        cfg.mutations = mutations;
+        cfg.batchSize = opts.getInt("batch", 1);
+        cfg.batchBestOfK = opts.get("batch-rule", "best") == "best";
+        cfg.masterSeed = seed;
+        int threads = opts.getInt("threads", max(1u, thread::hardware_concurrency()));
+        string resultsFile = opts.get("results", "batch_results.csv");
+        try {
+            vector<string> paths = collectInstances(argv[2]);
+            std::cout << "[Batch] Каталог " << argv[2] << ": " << paths.size() << " экземпляров, потоков: "
+                      << threads << ", seed = " << seed << std::endl;
+            auto start = chrono::steady_clock::now();
+            vector<BatchResult> results = runBatch(paths, cfg, threads);
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            writeBatchResults(resultsFile, results);
+
+            int failed = 0, optimal = 0;
+            double busy = 0;
+            for (const auto &r : results) {
+                busy += r.seconds;
+                if (r.error.empty() && r.bestK1 <= r.lowerBound) ++optimal;
+                if (!r.error.empty()) {
+                    ++failed;
+                    cerr << r.path << ": " << r.error << "\n";
+                }
+            }
+            std::cout << "Решено " << results.size() - failed << " из " << results.size() << " за "
+                      << elapsed.count() << " s, загрузка потоков "
+                      << 100.0 * busy / (elapsed.count() * max(1, min<int>(threads, paths.size()))) << "%\n";
+            std::cout << "Доказанно оптимальных (K1 на нижней границе): " << optimal << std::endl;
+            if (!operatorReport().empty()) operatorReport().print(cout);
+            std::cout << "Результаты записаны в " << resultsFile << std::endl;
+            if (opts.has("telemetry")) exportTelemetry(opts.get("telemetry", "telemetry.json"));
+            return failed ? 1 : 0;
+        }
+        catch (const exception &e) {
+            cerr << "Ошибка: " << e.what() << "\n";
+            return 1;
+        }
     }
     else if (argc >= 3 && string(argv[1]) == "file") {
         std::cout  << "[Mode 4] Ввод из файла: " << argv[2] << std::endl;
         try {
-            InputData data = readCSV(argv[2]);
+            InputData data = readInstance(argv[2]);
 
             N = data.N;
             M = data.M;
@@ -98,7 +183,21 @@ int main(int argc, char** argv) {
         std::cerr << "  ./main                    — авто режим\n";
         std::cerr << "  ./main default N M cooling [seed] — параметры из аргументов\n";
         std::cerr << "  ./main manual             — ввод вручную\n";
-        std::cerr << "  ./main file input.txt     — ввод из файла\n";
+        std::cerr << "  ./main file input.csv|.bin — ввод из файла (CSV или двоичный)\n";
+        std::cerr << "  ./main convert in.csv out.bin — сохранить экземпляр в двоичном формате\n";
+        std::cerr << "  ./main batch dir          — все *.csv и *.bin каталога на пуле потоков\n";
+        std::cerr << "Ключи (в любом месте):\n";
+        std::cerr << "  --layout=lists|flat       — раскладка расписания в памяти\n";
+        std::cerr << "  --init=roundrobin|greedy|lpt|k1 — начальное расписание\n";
+        std::cerr << "  --engine=virtual|static|lockstep — виртуальные интерфейсы, шаблонный движок или\n"
+                     "                             16 цепочек в SIMD-линиях (N <= 64, M <= 16; иначе static;\n"
+                     "                             AVX-512, без него — скалярно; только --mutations=uniform)\n";
+        std::cerr << "  --mutations=uniform|guided|adaptive — равномерные ходы, ещё и ходы с критических процессоров,\n"
+                     "                             те же с адаптивными долями (бандит)\n";
+        std::cerr << "  --seed=S                  — мастер-сид (данные, мутации, потоки)\n";
+        std::cerr << "  --batch=K --batch-rule=best|sequential — K кандидатов на шаг отжига\n";
+        std::cerr << "  --threads=P --results=out.csv — потоки и файл итогов режима batch\n";
+        std::cerr << "  --telemetry=out.json      — счётчики и трасса отжига (сборка с -DSA_TELEMETRY)\n";
         std::cout << std::endl;
         return 1;
     }
@@ -110,19 +209,18 @@ int main(int argc, char** argv) {
     std::cout << "\nПараметры:" << std::endl;
     std::cout << "  N = " << N << ", M = " << M << ", seed = " << seed << std::endl;
     std::cout << "  Закон охлаждения: " << coolingType << std::endl;
+    std::cout << "  Раскладка: " << layout << ", движок: " << engine << ", старт: " << init
+              << ", мутации: " << mutations << std::endl;
+    double lowerBound = k1LowerBound(w, M); // отжиг, дошедший до неё, останавливается
+    std::cout << "  Нижняя граница K1: " << (long long)lowerBound << std::endl;
     std::cout << "  Времена работ: " << std::endl;
     //for (int t : w) cout << t << " ";
     std::cout << std::endl << std::endl;
 
-    auto initial = ScheduleSolution(N, M, w);
-    std::cout << "Initial solution:\n" << initial.toString() << std::endl;
-
-    // Мутации
-    vector<shared_ptr<Mutation>> muts = {
-        make_shared<SwapTwoJobs>(),
-        make_shared<MoveJob>()
-    };
-    shared_ptr<Mutation> composite = make_shared<CompositeMutation>(muts);
+    // Раскладка решения: вектор векторов (по умолчанию) или один плоский массив с зазорами;
+    // стартовая раздача работ — round-robin или конструктивная (--init)
+    unique_ptr<Solution> initial = makeInitialSolution(layout, init, N, M, w);
+    std::cout << "Initial solution:\n" << initial->toString() << std::endl;
 
     // ------------------ Закон охлаждения ------------------
     double T0 = 100.0;
@@ -144,14 +242,29 @@ int main(int argc, char** argv) {
 
 
     // ------------------ Запуск ИО ------------------
-    SimulatedAnnealing sa(T0, maxIter, NO_IMPROVE_LIMIT, move(cooling), composite, seed);
-    
+    // static и lockstep строят свои движки сами; SimulatedAnnealing нужен только виртуальному
     auto start = chrono::steady_clock::now();
-    unique_ptr<Solution> best = sa.run(initial);
+    unique_ptr<Solution> best;
+    if (engine == "static") {
+        best = runStaticAnnealing(*initial, coolingType, T0, maxIter, NO_IMPROVE_LIMIT, seed, lowerBound, mutations);
+    } else if (engine == "lockstep") {
+        best = runLockstepAnnealing(*initial, coolingType, T0, maxIter, NO_IMPROVE_LIMIT, seed, lowerBound, mutations);
+    } else {
+        // Мутации: Swap + Move, с --mutations=guided — ещё и направленные (MoveFromCritical, SwapMinHead)
+        shared_ptr<Mutation> composite = makeMutation(mutations);
+        SimulatedAnnealing sa(T0, maxIter, NO_IMPROVE_LIMIT, move(cooling), composite, seed);
+        sa.batchSize = opts.getInt("batch", 1);
+        sa.batchBestOfK = opts.get("batch-rule", "best") == "best";
+        sa.lowerBound = lowerBound;
+        best = sa.run(*initial);
+    }
     auto finish = chrono::steady_clock::now();
     chrono::duration<double> elapsed = finish - start;
 
     cout << "Best solution found (time " << elapsed.count() << " s):\n";
     cout << best->toString() << "\n";
+    cout << gapReport(best->criteria(), lowerBound) << "\n";
+    if (!operatorReport().empty()) operatorReport().print(cout);
+    if (opts.has("telemetry")) exportTelemetry(opts.get("telemetry", "telemetry.json"));
     return 0;
 }
@@ -6,12 +6,29 @@ main_parallel.cpp
 
 #include <bits/stdc++.h>
 #include "headers/abstruct.h"
+#include "headers/simd_kernels.h"
+#include "headers/k1_index.h"
+#include "headers/job_durations.h"
 #include "headers/solution.h"
+#include "headers/flat_solution.h"
+#include "headers/solution_pool.h"
+#include "headers/initializers.h"
+#include "headers/lower_bound.h"
+#include "headers/operator_bandit.h"
+#include "headers/mutations.h"
 #include "headers/cooling_laws.h"
+#include "headers/telemetry.h"
+#include "headers/static_engine.h"
+#include "headers/rng_streams.h"
+#include "headers_parallel/epoch_barrier.h"
 #include "headers_parallel/head_class_parallel.h"
+#include "headers_parallel/checkpoint.h"
 #include "headers_parallel/parallel_loop.h"
+#include "headers_parallel/island_model.h"
+#include "headers_parallel/parallel_tempering.h"
+#include "headers_parallel/racing.h"
 #include "headers/data_io.h"
-#include "headers/mutations.h"
+#include "headers/cli_options.h"
 
 using namespace std;
 
@@ -21,7 +38,8 @@ using namespace std;
    - class Mutation (abstract): абстракция операции мутации (изменения решения).
    - class CoolingLaw (abstract): интерфейс закона понижения температуры.
    - class SimulatedAnnealing: главный класс, реализующий цикл ИО, принимает конкретные реализации выше.
-   - Конкретная реализация для задачи расписания: ScheduleSolution, конкретные мутации (Swap, Move).
+   - Конкретная реализация для задачи расписания: ScheduleSolution, конкретные мутации (Swap, Move;
+     направленные MoveFromCritical и SwapMinHead — с --mutations=guided, с адаптивными долями — adaptive).
    - Реализованы три закона понижения температуры: Exponential, Linear, Logarithmic.
 */
 
@@ -30,12 +48,70 @@ int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
+    Options opts = extractOptions(argc, argv);
+    string layout = opts.get("layout", "lists"); // lists | flat
+    string init = opts.get("init", "roundrobin"); // roundrobin | greedy | lpt | k1
+    string engine = opts.get("engine", "virtual"); // virtual | static
+    string parallelMode = opts.get("parallel", "epochs"); // epochs | island | tempering | racing
+    int migrationInterval = opts.getInt("migrate", 1000);  // для island: итераций между обменами
+    string topology = opts.get("topology", "ring");        // для island: ring | broadcast
+    int replicas = opts.getInt("replicas", 0);             // для tempering: число реплик (0 — по одной на поток)
+    double Tmin = opts.getDouble("tmin", 0.5);             // для tempering: нижняя ступень лестницы (верхняя — T0)
+    int sweep = opts.getInt("sweep", 1000);                // для tempering: итераций между обменами реплик
+    int chains = opts.getInt("chains", 0);                 // для racing: число цепочек (0 — по четыре на поток)
+    long long rungSteps = opts.getInt("rung", 2000);       // для racing: итераций на цепочку на первой ступени
+    int eta = opts.getInt("eta", 2);                       // для racing: на ступени остаётся 1 / eta цепочек
+
+    CheckpointOptions checkpoint;
+    checkpoint.path = opts.get("checkpoint", "");                    // для epochs: файл контрольной точки
+    checkpoint.everySeconds = opts.getDouble("checkpoint-every", 60); // не чаще раза в столько секунд
+
+    // ------------------ Продолжение с контрольной точки ------------------
+    if (argc == 3 && string(argv[1]) == "resume") {
+        Checkpoint c;
+        try {
+            c = readCheckpoint(argv[2]);
+        }
+        catch (const exception &e) {
+            cerr << "Ошибка: " << e.what() << "\n";
+            return 1;
+        }
+        std::cout << "[Resume] Контрольная точка " << argv[2] << ": эпоха " << c.epoch
+                  << ", эпох без улучшения " << c.globalNoImprove << std::endl;
+        std::cout << "  N = " << c.N << ", M = " << c.M << ", seed = " << c.masterSeed
+                  << ", потоков = " << c.Nproc << ", охлаждение: " << c.coolingType << std::endl;
+
+        ScheduleSolution lists(c.N, c.M, c.w, c.bestLists);
+        unique_ptr<Solution> initial;
+        if (c.layout == "flat") initial = make_unique<FlatScheduleSolution>(lists);
+        else initial = make_unique<ScheduleSolution>(move(lists));
+        std::cout << "Best so far:\n" << initial->toString() << std::endl;
+
+        EngineOptions eo{c.engine, c.batchSize, c.batchBestOfK, k1LowerBound(c.w, c.M), c.mutations};
+        if (checkpoint.path.empty()) checkpoint.path = argv[2]; // дальше пишем туда же
+        checkpoint.resume = &c;
+
+        auto start = chrono::steady_clock::now();
+        parallelSimulatedAnnealing(*initial, c.Nproc, c.T0, c.maxIter, c.noImproveLimit,
+                                   makeMutation(c.mutations), c.coolingType, c.masterSeed, eo, checkpoint);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        std::cout << "Общее время работы: " << elapsed.count() << " секунд" << std::endl << std::endl;
+        if (!operatorReport().empty()) operatorReport().print(cout);
+        return 0;
+    }
+
+    EngineOptions engineOpts;
+    engineOpts.engine = engine;
+    engineOpts.batchSize = opts.getInt("batch", 1);
+    engineOpts.batchBestOfK = opts.get("batch-rule", "best") == "best";
+    engineOpts.mutations = opts.get("mutations", "uniform"); // uniform | guided | adaptive
+
     int N = 5, M = 2;
     int minW = 1, maxW = 20;
-    uint32_t seed = 0;
+    uint32_t seed = opts.getInt("seed", 0); // 0 — случайный; напечатанный сид воспроизводит прогон
     string mode = "auto";        // режим по умолчанию
     string coolingType = "Cauchy";
-    vector<int> w;               // длительности работ
+    JobDurations w;              // длительности работ (общая таблица всех решений)
 
 
     random_device rd;
@@ -56,14 +132,14 @@ int main(int argc, char** argv) {
     if (argc == 1) {
         std::cout << "[Mode 1] Автоматическая генерация (по умолчанию)" << std::endl;
         N = 5; M = 2;
-        w = generateDurations(N, minW, maxW, rng);
+        w = JobDurations(generateDurations(N, minW, maxW, rng));
     }
     else if (argc == 5 && string(argv[1]) == "default") {
         std::cout << "[Mode 2] Аргументы командной строки" << std::endl;
         N = stoi(argv[2]);
         M = stoi(argv[3]);
         coolingType = argv[4];
-        w = generateDurations(N, minW, maxW, rng);
+        w = JobDurations(generateDurations(N, minW, maxW, rng));
     }
     else if (argc == 2 && string(argv[1]) == "manual") {
         std::cout << "[Mode 3] Ввод вручную" << std::endl;
@@ -72,13 +148,14 @@ int main(int argc, char** argv) {
         std::cout  << "Введите закон охлаждения (Cauchy / Boltzmann / Mixed): " << std::endl;
         cin >> coolingType;
         std::cout  << "Введите длительности " << N << " работ: " << std::endl;
-        w.resize(N);
-        for (int i = 0; i < N; ++i) cin >> w[i];
+        vector<int> typed(N);
+        for (int i = 0; i < N; ++i) cin >> typed[i];
+        w = JobDurations(typed);
     }
     else if (argc >= 3 && string(argv[1]) == "file") {
         std::cout  << "[Mode 4] Ввод из файла: " << argv[2] << std::endl;
         try {
-            InputData data = readCSV(argv[2]);
+            InputData data = readInstance(argv[2]);
 
             N = data.N;
             M = data.M;
@@ -101,7 +178,22 @@ int main(int argc, char** argv) {
         std::cerr << "  ./main                     — авто режим\n";
         std::cerr << "  ./main default N M cooling — параметры из аргументов\n";
         std::cerr << "  ./main manual              — ввод вручную\n";
-        std::cerr << "  ./main file input.txt Nproc      — ввод из файла\n";
+        std::cerr << "  ./main file input.csv|.bin Nproc — ввод из файла (CSV или двоичный)\n";
+        std::cerr << "  ./main resume ckpt.bin     — продолжить прогон с контрольной точки\n";
+        std::cerr << "Ключи (в любом месте):\n";
+        std::cerr << "  --layout=lists|flat       — раскладка расписания в памяти\n";
+        std::cerr << "  --init=roundrobin|greedy|lpt|k1 — начальное расписание\n";
+        std::cerr << "  --engine=virtual|static   — виртуальные интерфейсы или шаблонный движок\n";
+        std::cerr << "  --mutations=uniform|guided|adaptive — равномерные ходы, ещё и ходы с критических процессоров,\n"
+                     "                             те же с адаптивными долями (бандит)\n";
+        std::cerr << "  --seed=S                  — мастер-сид (данные, мутации, потоки)\n";
+        std::cerr << "  --batch=K --batch-rule=best|sequential — K кандидатов на шаг отжига\n";
+        std::cerr << "  --telemetry=out.json      — счётчики, время потоков и эпох, трасса (сборка с -DSA_TELEMETRY)\n";
+        std::cerr << "  --parallel=epochs|island  — синхронные эпохи или асинхронные острова\n";
+        std::cerr << "  --checkpoint=ckpt.bin --checkpoint-every=S — контрольные точки режима epochs (раз в 60 с, и посреди долгой эпохи)\n";
+        std::cerr << "  --migrate=K --topology=ring|broadcast — интервал и схема миграции островов\n";
+        std::cerr << "  --parallel=tempering --replicas=R --tmin=T --sweep=K — обмен репликами\n";
+        std::cerr << "  --parallel=racing --chains=C --rung=K --eta=E — гонка цепочек с отсевом отстающих\n";
         std::cout << std::endl;
         return 1;
     }
@@ -110,22 +202,24 @@ int main(int argc, char** argv) {
 
     // ------------------ Настройки -----------------
     std::cout << "\nПараметры:" << std::endl;
-    std::cout << "=== Параллельная версия (threads=" << Nproc << ") ===" << std::endl;
+    std::cout << "=== Параллельная версия (threads=" << Nproc << ", " << parallelMode << ") ===" << std::endl;
     std::cout << "  N = " << N << ", M = " << M << ", seed = " << seed << std::endl;
     std::cout << "  Закон охлаждения: " << coolingType << std::endl;
+    std::cout << "  Раскладка: " << layout << ", движок: " << engine << ", старт: " << init
+              << ", мутации: " << engineOpts.mutations << std::endl;
+    engineOpts.lowerBound = k1LowerBound(w, M); // запуск, дошедший до неё, останавливается
+    std::cout << "  Нижняя граница K1: " << (long long)engineOpts.lowerBound << std::endl;
     std::cout << "  Времена работ: " << std::endl;
     //for (int t : w) cout << t << " ";
     std::cout << std::endl << std::endl;
 
-    auto initial = ScheduleSolution(N, M, w);
-    std::cout << "Initial solution:\n" << initial.toString() << std::endl;
+    // Раскладка решения: вектор векторов (по умолчанию) или один плоский массив с зазорами;
+    // стартовая раздача работ — round-robin или конструктивная (--init)
+    unique_ptr<Solution> initial = makeInitialSolution(layout, init, N, M, w);
+    std::cout << "Initial solution:\n" << initial->toString() << std::endl;
 
-    // Мутации
-    vector<shared_ptr<Mutation>> muts = {
-        make_shared<SwapTwoJobs>(),
-        make_shared<MoveJob>()
-    };
-    shared_ptr<Mutation> composite = make_shared<CompositeMutation>(muts);
+    // Мутации: Swap + Move, с --mutations=guided — ещё и направленные (MoveFromCritical, SwapMinHead)
+    shared_ptr<Mutation> composite = makeMutation(engineOpts.mutations);
 
     // ------------------ Закон охлаждения ------------------
     double T0 = 100.0;
@@ -148,11 +242,23 @@ int main(int argc, char** argv) {
     // --------------------------- Запуск параллельного ИО ----------------------------------
     auto start = chrono::steady_clock::now();
     
-    parallelSimulatedAnnealing(initial, Nproc, T0, maxIter, NO_IMPROVE_LIMIT, composite, coolingType);
+    if (parallelMode == "tempering")
+        parallelTempering(*initial, Nproc, replicas > 0 ? replicas : Nproc, Tmin, T0, sweep, composite, seed, engineOpts);
+    else if (parallelMode == "racing")
+        racingSimulatedAnnealing(*initial, Nproc, chains > 0 ? chains : 4 * Nproc, T0, maxIter, NO_IMPROVE_LIMIT,
+                                 composite, coolingType, seed, engineOpts, rungSteps, eta);
+    else if (parallelMode == "island")
+        islandSimulatedAnnealing(*initial, Nproc, T0, maxIter, NO_IMPROVE_LIMIT, composite, coolingType, seed, engineOpts,
+                                 migrationInterval, topology);
+    else
+        parallelSimulatedAnnealing(*initial, Nproc, T0, maxIter, NO_IMPROVE_LIMIT, composite, coolingType, seed, engineOpts,
+                                   checkpoint);
     
     auto finish = chrono::steady_clock::now();
     chrono::duration<double> elapsed = finish - start;
     std::cout << "Общее время работы: " << elapsed.count() << " секунд" << std::endl << std::endl;
+    if (!operatorReport().empty()) operatorReport().print(cout);
+    if (opts.has("telemetry")) exportTelemetry(opts.get("telemetry", "telemetry.json"));
 
     
     return 0;